@@ -0,0 +1,371 @@
+/*
+ * xfce4-axisclock-plugin - A macOS-style clock plugin for the Xfce panel
+ *
+ * Copyright (c) 2025 Kamil 'Novik' Nowicki <novik@axisos.org>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Website: https://axisos.org
+ * Repository: https://github.com/AxisOS/xfce4-axisclock-plugin
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <gtk/gtk.h>
+#include <stdio.h>
+#include <time.h>
+
+#include "alarms.h"
+#include "deadline_queue.h"
+
+/* One daily alarm, "HH:MM[ message]" */
+typedef struct {
+    AxisClockAlarms   *owner;
+    gint               hour;
+    gint               minute;
+    gchar             *message;
+    AxisClockDeadline *deadline;
+} Alarm;
+
+struct _AxisClockAlarms {
+    GPtrArray                  *alarms;             /* Alarm */
+    AxisClockDeadline          *countdown;
+    gint64                      stopwatch_started;  /* Monotonic, 0 when stopped */
+    gint64                      stopwatch_elapsed;  /* Before the last start */
+    AxisClockAlarmsChangedFunc  changed_func;
+    gpointer                    changed_data;
+};
+
+static void
+alarms_notify_changed(AxisClockAlarms *alarms)
+{
+    if (alarms->changed_func != NULL)
+        alarms->changed_func(alarms, alarms->changed_data);
+}
+
+/* Non-modal, so a missed alarm does not block the panel */
+static void
+alarms_show_message(const gchar *message)
+{
+    GtkWidget *dialog;
+    
+    dialog = gtk_message_dialog_new(NULL, 0, GTK_MESSAGE_INFO, GTK_BUTTONS_CLOSE, "%s", message);
+    gtk_window_set_title(GTK_WINDOW(dialog), "AxisClock");
+    gtk_window_set_keep_above(GTK_WINDOW(dialog), TRUE);
+    g_signal_connect(dialog, "response", G_CALLBACK(gtk_widget_destroy), NULL);
+    gtk_widget_show(dialog);
+    gdk_display_beep(gdk_display_get_default());
+}
+
+/* Next local wall-clock time of @alarm, in g_get_real_time() microseconds */
+static gint64
+alarm_next_time(const Alarm *alarm)
+{
+    time_t now = time(NULL);
+    time_t next;
+    struct tm tm;
+    
+    localtime_r(&now, &tm);
+    tm.tm_hour = alarm->hour;
+    tm.tm_min = alarm->minute;
+    tm.tm_sec = 0;
+    tm.tm_isdst = -1;
+    next = mktime(&tm);
+    
+    if (next <= now) {
+        /* mktime normalised @tm; set the time again in case DST moved it */
+        tm.tm_mday++;
+        tm.tm_hour = alarm->hour;
+        tm.tm_min = alarm->minute;
+        tm.tm_isdst = -1;
+        next = mktime(&tm);
+    }
+    
+    return (gint64)next * G_USEC_PER_SEC;
+}
+
+static void alarm_fired_cb(gpointer user_data);
+
+static void
+alarm_schedule(Alarm *alarm)
+{
+    alarm->deadline = axisclock_deadline_add(AXISCLOCK_DEADLINE_REALTIME, alarm_next_time(alarm),
+                                             alarm_fired_cb, alarm);
+}
+
+static void
+alarm_fired_cb(gpointer user_data)
+{
+    Alarm *alarm = user_data;
+    
+    alarm->deadline = NULL;
+    alarms_show_message(alarm->message);
+    alarm_schedule(alarm);
+}
+
+static void
+alarm_free(gpointer data)
+{
+    Alarm *alarm = data;
+    
+    if (alarm->deadline != NULL)
+        axisclock_deadline_remove(alarm->deadline);
+    g_free(alarm->message);
+    g_free(alarm);
+}
+
+/* Parse "HH:MM" optionally followed by a message */
+static Alarm *
+alarm_new(AxisClockAlarms *alarms, const gchar *spec)
+{
+    Alarm *alarm;
+    gint hour, minute, consumed = 0;
+    const gchar *message;
+    
+    if (sscanf(spec, "%d:%d%n", &hour, &minute, &consumed) != 2 ||
+        hour < 0 || hour > 23 || minute < 0 || minute > 59)
+        return NULL;
+    
+    message = spec + consumed;
+    while (g_ascii_isspace(*message))
+        message++;
+    
+    alarm = g_new0(Alarm, 1);
+    alarm->owner = alarms;
+    alarm->hour = hour;
+    alarm->minute = minute;
+    alarm->message = *message != '\0' ? g_strdup(message)
+                                      : g_strdup_printf("Alarm %02d:%02d", hour, minute);
+    
+    return alarm;
+}
+
+/**
+ * axisclock_alarms_new:
+ * @func: Called when the countdown or stopwatch state changes
+ * @user_data: Passed to @func
+ *
+ * Returns: A new #AxisClockAlarms with nothing scheduled.
+ */
+AxisClockAlarms *
+axisclock_alarms_new(AxisClockAlarmsChangedFunc func, gpointer user_data)
+{
+    AxisClockAlarms *alarms = g_new0(AxisClockAlarms, 1);
+    
+    alarms->alarms = g_ptr_array_new_with_free_func(alarm_free);
+    alarms->changed_func = func;
+    alarms->changed_data = user_data;
+    
+    return alarms;
+}
+
+/**
+ * axisclock_alarms_free:
+ * @alarms: A #AxisClockAlarms
+ *
+ * Cancels everything pending and frees @alarms.
+ */
+void
+axisclock_alarms_free(AxisClockAlarms *alarms)
+{
+    if (alarms == NULL)
+        return;
+    
+    if (alarms->countdown != NULL)
+        axisclock_deadline_remove(alarms->countdown);
+    g_ptr_array_free(alarms->alarms, TRUE);
+    g_free(alarms);
+}
+
+/**
+ * axisclock_alarms_set_schedule:
+ * @alarms: A #AxisClockAlarms
+ * @specs: %NULL-terminated list of "HH:MM[ message]" daily alarms
+ *
+ * Replaces all alarms. Invalid entries are skipped with a warning.
+ */
+void
+axisclock_alarms_set_schedule(AxisClockAlarms *alarms, const gchar * const *specs)
+{
+    g_return_if_fail(alarms != NULL);
+    
+    g_ptr_array_set_size(alarms->alarms, 0);
+    
+    for (; specs != NULL && *specs != NULL; specs++) {
+        Alarm *alarm = alarm_new(alarms, *specs);
+        
+        if (alarm == NULL) {
+            g_warning("Invalid alarm '%s', expected HH:MM", *specs);
+            continue;
+        }
+        
+        alarm_schedule(alarm);
+        g_ptr_array_add(alarms->alarms, alarm);
+    }
+}
+
+static void
+countdown_fired_cb(gpointer user_data)
+{
+    AxisClockAlarms *alarms = user_data;
+    
+    alarms->countdown = NULL;
+    alarms_show_message("Timer finished");
+    alarms_notify_changed(alarms);
+}
+
+/**
+ * axisclock_alarms_start_countdown:
+ * @alarms: A #AxisClockAlarms
+ * @seconds: Length of the countdown
+ *
+ * Starts the countdown, restarting it if one is already running. The
+ * deadline is monotonic, so setting the clock does not shorten it.
+ */
+void
+axisclock_alarms_start_countdown(AxisClockAlarms *alarms, guint seconds)
+{
+    g_return_if_fail(alarms != NULL);
+    
+    if (alarms->countdown != NULL)
+        axisclock_deadline_remove(alarms->countdown);
+    
+    alarms->countdown = axisclock_deadline_add(AXISCLOCK_DEADLINE_MONOTONIC,
+                                               g_get_monotonic_time() + (gint64)seconds * G_USEC_PER_SEC,
+                                               countdown_fired_cb, alarms);
+    alarms_notify_changed(alarms);
+}
+
+/**
+ * axisclock_alarms_cancel_countdown:
+ * @alarms: A #AxisClockAlarms
+ */
+void
+axisclock_alarms_cancel_countdown(AxisClockAlarms *alarms)
+{
+    g_return_if_fail(alarms != NULL);
+    
+    if (alarms->countdown == NULL)
+        return;
+    
+    axisclock_deadline_remove(alarms->countdown);
+    alarms->countdown = NULL;
+    alarms_notify_changed(alarms);
+}
+
+/**
+ * axisclock_alarms_toggle_stopwatch:
+ * @alarms: A #AxisClockAlarms
+ *
+ * Starts the stopwatch, or pauses it if it is running.
+ */
+void
+axisclock_alarms_toggle_stopwatch(AxisClockAlarms *alarms)
+{
+    g_return_if_fail(alarms != NULL);
+    
+    if (alarms->stopwatch_started != 0) {
+        alarms->stopwatch_elapsed += g_get_monotonic_time() - alarms->stopwatch_started;
+        alarms->stopwatch_started = 0;
+    } else {
+        alarms->stopwatch_started = g_get_monotonic_time();
+    }
+    
+    alarms_notify_changed(alarms);
+}
+
+/**
+ * axisclock_alarms_reset_stopwatch:
+ * @alarms: A #AxisClockAlarms
+ *
+ * Stops the stopwatch and clears its time.
+ */
+void
+axisclock_alarms_reset_stopwatch(AxisClockAlarms *alarms)
+{
+    g_return_if_fail(alarms != NULL);
+    
+    alarms->stopwatch_started = 0;
+    alarms->stopwatch_elapsed = 0;
+    alarms_notify_changed(alarms);
+}
+
+/**
+ * axisclock_alarms_is_running:
+ * @alarms: A #AxisClockAlarms
+ *
+ * Returns: %TRUE while the countdown or stopwatch needs per-second updates.
+ */
+gboolean
+axisclock_alarms_is_running(AxisClockAlarms *alarms)
+{
+    g_return_val_if_fail(alarms != NULL, FALSE);
+    
+    return alarms->countdown != NULL || alarms->stopwatch_started != 0;
+}
+
+static void
+append_duration(GString *text, gint64 seconds)
+{
+    if (seconds >= 3600)
+        g_string_append_printf(text, "%d:%02d:%02d", (gint)(seconds / 3600),
+                               (gint)(seconds / 60 % 60), (gint)(seconds % 60));
+    else
+        g_string_append_printf(text, "%02d:%02d", (gint)(seconds / 60), (gint)(seconds % 60));
+}
+
+/**
+ * axisclock_alarms_format:
+ * @alarms: A #AxisClockAlarms
+ *
+ * Renders the countdown as "−MM:SS" and a used stopwatch as "+MM:SS".
+ *
+ * Returns: Text for the panel label, or %NULL if neither is in use.
+ */
+gchar *
+axisclock_alarms_format(AxisClockAlarms *alarms)
+{
+    gint64 now = g_get_monotonic_time();
+    gint64 elapsed;
+    GString *text;
+    
+    g_return_val_if_fail(alarms != NULL, NULL);
+    
+    elapsed = alarms->stopwatch_elapsed;
+    if (alarms->stopwatch_started != 0)
+        elapsed += now - alarms->stopwatch_started;
+    
+    if (alarms->countdown == NULL && elapsed == 0)
+        return NULL;
+    
+    text = g_string_new(NULL);
+    
+    if (alarms->countdown != NULL) {
+        gint64 remaining = axisclock_deadline_get_time(alarms->countdown) - now;
+        
+        /* Round up so the display reaches 00:00 as the timer fires */
+        g_string_append(text, "−");
+        append_duration(text, (MAX(remaining, 0) + G_USEC_PER_SEC - 1) / G_USEC_PER_SEC);
+    }
+    
+    if (elapsed > 0) {
+        g_string_append(text, text->len > 0 ? " +" : "+");
+        append_duration(text, elapsed / G_USEC_PER_SEC);
+    }
+    
+    return g_string_free(text, FALSE);
+}
@@ -0,0 +1,58 @@
+/*
+ * xfce4-axisclock-plugin - A macOS-style clock plugin for the Xfce panel
+ *
+ * Copyright (c) 2025 Kamil 'Novik' Nowicki <novik@axisos.org>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Website: https://axisos.org
+ * Repository: https://github.com/AxisOS/xfce4-axisclock-plugin
+ */
+
+#ifndef __ALARMS_H__
+#define __ALARMS_H__
+
+#include <glib.h>
+
+G_BEGIN_DECLS
+
+typedef struct _AxisClockAlarms AxisClockAlarms;
+
+/* Called when the countdown or stopwatch starts, stops or finishes */
+typedef void (*AxisClockAlarmsChangedFunc) (AxisClockAlarms *alarms,
+                                            gpointer         user_data);
+
+/*
+ * Daily alarms, a one-shot countdown and a stopwatch for one plugin
+ * instance. Alarms and the countdown are absolute deadlines in the shared
+ * deadline queue (wall clock and monotonic respectively), so they cost no
+ * wakeups until due. The stopwatch needs no deadline at all.
+ */
+AxisClockAlarms *axisclock_alarms_new              (AxisClockAlarmsChangedFunc  func,
+                                                    gpointer                    user_data);
+void             axisclock_alarms_free             (AxisClockAlarms            *alarms);
+void             axisclock_alarms_set_schedule     (AxisClockAlarms            *alarms,
+                                                    const gchar * const        *specs);
+void             axisclock_alarms_start_countdown  (AxisClockAlarms            *alarms,
+                                                    guint                       seconds);
+void             axisclock_alarms_cancel_countdown (AxisClockAlarms            *alarms);
+void             axisclock_alarms_toggle_stopwatch (AxisClockAlarms            *alarms);
+void             axisclock_alarms_reset_stopwatch  (AxisClockAlarms            *alarms);
+gboolean         axisclock_alarms_is_running       (AxisClockAlarms            *alarms);
+gchar           *axisclock_alarms_format           (AxisClockAlarms            *alarms);
+
+G_END_DECLS
+
+#endif /* !__ALARMS_H__ */
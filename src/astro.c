@@ -0,0 +1,205 @@
+/*
+ * xfce4-axisclock-plugin - A macOS-style clock plugin for the Xfce panel
+ *
+ * Copyright (c) 2025 Kamil 'Novik' Nowicki <novik@axisos.org>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Website: https://axisos.org
+ * Repository: https://github.com/AxisOS/xfce4-axisclock-plugin
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <glib.h>
+#include <math.h>
+#include <time.h>
+
+#include "astro.h"
+#include "profiler.h"
+
+/* Mean synodic month and a reference new moon (2000-01-06 18:14 UTC) in
+ * days since 1970-01-01; good to about half a day */
+#define SYNODIC_MONTH 29.530588853
+#define REFERENCE_NEW_MOON 10962.7597
+
+/* Days from 1970-01-01 to 2000-01-01 (J2000 is noon of that day) */
+#define DAYS_TO_J2000 10957
+
+/* Pages kept; covers paging a few months back and forth */
+#define ASTRO_CACHE_SIZE 4
+
+#define DEG (G_PI / 180.0)
+
+static AxisClockAstroMonth astro_cache[ASTRO_CACHE_SIZE];
+static gboolean astro_cache_valid[ASTRO_CACHE_SIZE];
+static guint astro_cache_next;
+
+/*
+ * Sunrise equation for @n days, UTC results in days since 1970-01-01.
+ * Branch-free so the loop vectorizes; a sun that never rises or sets
+ * leaves @polar set and the times clamped to solar noon or midnight.
+ */
+static void
+sun_kernel(const gdouble *restrict days, gint n, gdouble latitude, gdouble longitude,
+           gdouble *restrict rise, gdouble *restrict set, gdouble *restrict polar)
+{
+    const gdouble sin_lat = sin(latitude * DEG);
+    const gdouble cos_lat = cos(latitude * DEG);
+    const gdouble sin_altitude = sin(-0.833 * DEG);
+    
+    for (gint i = 0; i < n; i++) {
+        gdouble j_star = days[i] - DAYS_TO_J2000 - longitude / 360.0;
+        gdouble m = fmod(357.5291 + 0.98560028 * j_star, 360.0) * DEG;
+        gdouble c = 1.9148 * sin(m) + 0.02 * sin(2.0 * m) + 0.0003 * sin(3.0 * m);
+        gdouble lambda = fmod(m / DEG + c + 180.0 + 102.9372, 360.0) * DEG;
+        gdouble transit = j_star + 0.0053 * sin(m) - 0.0069 * sin(2.0 * lambda) + DAYS_TO_J2000 + 0.5;
+        gdouble sin_decl = sin(lambda) * sin(23.4397 * DEG);
+        gdouble cos_decl = sqrt(1.0 - sin_decl * sin_decl);
+        gdouble cos_hour = (sin_altitude - sin_lat * sin_decl) / (cos_lat * cos_decl);
+        gdouble clamped = fmin(fmax(cos_hour, -1.0), 1.0);
+        gdouble half_day = acos(clamped) / (2.0 * G_PI);
+        
+        rise[i] = transit - half_day;
+        set[i] = transit + half_day;
+        polar[i] = fabs(cos_hour) > 1.0 ? 1.0 : 0.0;
+    }
+}
+
+/* Mean moon age at local noon and the quarter crossed during each day */
+static void
+moon_kernel(const gdouble *restrict days, gint n, gdouble *restrict age, gdouble *restrict quarter)
+{
+    const gdouble quarter_length = SYNODIC_MONTH / 4.0;
+    
+    for (gint i = 0; i < n; i++) {
+        gdouble since = days[i] - REFERENCE_NEW_MOON;
+        gdouble q0 = floor(since / quarter_length);
+        gdouble q1 = floor((since + 1.0) / quarter_length);
+        gdouble noon = since + 0.5;
+        
+        age[i] = noon - SYNODIC_MONTH * floor(noon / SYNODIC_MONTH);
+        /* Quarter index 0-3 if one starts within the day, -1 otherwise */
+        quarter[i] = q1 != q0 ? q1 - 4.0 * floor(q1 / 4.0) : -1.0;
+    }
+}
+
+static void
+astro_compute(AxisClockAstroMonth *month)
+{
+    gdouble days[AXISCLOCK_ASTRO_CELLS];
+    gdouble local_days[AXISCLOCK_ASTRO_CELLS];
+    gdouble offsets[AXISCLOCK_ASTRO_CELLS];
+    gdouble polar[AXISCLOCK_ASTRO_CELLS];
+    gdouble quarter[AXISCLOCK_ASTRO_CELLS];
+    
+    /* Zone offsets need localtime_r, so they are gathered up front */
+    for (gint i = 0; i < AXISCLOCK_ASTRO_CELLS; i++) {
+        time_t noon = ((time_t)month->first_day + i) * 86400 + 43200;
+        struct tm tm;
+        
+        localtime_r(&noon, &tm);
+        days[i] = month->first_day + i;
+        offsets[i] = tm.tm_gmtoff / 86400.0;
+        local_days[i] = days[i] - offsets[i];
+    }
+    
+    sun_kernel(days, AXISCLOCK_ASTRO_CELLS, month->latitude, month->longitude,
+               month->sunrise, month->sunset, polar);
+    moon_kernel(local_days, AXISCLOCK_ASTRO_CELLS, month->moon_age, quarter);
+    
+    /* UTC day numbers to local minutes after midnight */
+    for (gint i = 0; i < AXISCLOCK_ASTRO_CELLS; i++) {
+        gdouble rise = (month->sunrise[i] + offsets[i] - days[i]) * 1440.0;
+        gdouble set = (month->sunset[i] + offsets[i] - days[i]) * 1440.0;
+        
+        month->sunrise[i] = polar[i] != 0.0 ? -1.0 : rise - 1440.0 * floor(rise / 1440.0);
+        month->sunset[i] = polar[i] != 0.0 ? -1.0 : set - 1440.0 * floor(set / 1440.0);
+        month->moon_quarter[i] = (gint8)quarter[i];
+    }
+}
+
+/**
+ * axisclock_astro_get_month:
+ * @first_day: Day number of the first cell of the page
+ * @latitude: Degrees, north positive
+ * @longitude: Degrees, east positive
+ *
+ * Returns: The cached page, computed on first use. Valid until the next call.
+ */
+const AxisClockAstroMonth *
+axisclock_astro_get_month(gint32 first_day, gdouble latitude, gdouble longitude)
+{
+    AxisClockAstroMonth *month;
+    
+    for (guint i = 0; i < ASTRO_CACHE_SIZE; i++) {
+        month = &astro_cache[i];
+        if (astro_cache_valid[i] && month->first_day == first_day &&
+            month->latitude == latitude && month->longitude == longitude)
+            return month;
+    }
+    
+    AXISCLOCK_PROBE_BEGIN(probe_start);
+    
+    /* Round-robin replacement */
+    month = &astro_cache[astro_cache_next];
+    astro_cache_valid[astro_cache_next] = TRUE;
+    astro_cache_next = (astro_cache_next + 1) % ASTRO_CACHE_SIZE;
+    
+    month->first_day = first_day;
+    month->latitude = latitude;
+    month->longitude = longitude;
+    astro_compute(month);
+    
+    AXISCLOCK_PROBE_END(AXISCLOCK_PROBE_ASTRO, probe_start);
+    
+    return month;
+}
+
+/**
+ * axisclock_astro_phase_name:
+ * @moon_age: Days since new moon
+ *
+ * Returns: Name of the nearest of the eight principal phases.
+ */
+const gchar *
+axisclock_astro_phase_name(gdouble moon_age)
+{
+    static const gchar *names[8] = {
+        "New moon", "Waxing crescent", "First quarter", "Waxing gibbous",
+        "Full moon", "Waning gibbous", "Last quarter", "Waning crescent"
+    };
+    
+    return names[(gint)floor(moon_age / SYNODIC_MONTH * 8.0 + 0.5) % 8];
+}
+
+/**
+ * axisclock_astro_quarter_symbol:
+ * @quarter: A quarter, or %AXISCLOCK_MOON_NONE
+ *
+ * Returns: A moon glyph for @quarter, or %NULL.
+ */
+const gchar *
+axisclock_astro_quarter_symbol(AxisClockMoonQuarter quarter)
+{
+    static const gchar *symbols[4] = { "●", "◐", "○", "◑" };
+    
+    if (quarter < AXISCLOCK_MOON_NEW || quarter > AXISCLOCK_MOON_LAST_QUARTER)
+        return NULL;
+    
+    return symbols[quarter];
+}
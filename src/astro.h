@@ -0,0 +1,77 @@
+/*
+ * xfce4-axisclock-plugin - A macOS-style clock plugin for the Xfce panel
+ *
+ * Copyright (c) 2025 Kamil 'Novik' Nowicki <novik@axisos.org>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Website: https://axisos.org
+ * Repository: https://github.com/AxisOS/xfce4-axisclock-plugin
+ */
+
+#ifndef __ASTRO_H__
+#define __ASTRO_H__
+
+#include <glib.h>
+
+G_BEGIN_DECLS
+
+/* Cells in the calendar month model, 6 weeks x 7 days */
+#define AXISCLOCK_ASTRO_CELLS 42
+
+/* Moon quarter reached during a day, or NONE */
+typedef enum {
+    AXISCLOCK_MOON_NONE = -1,
+    AXISCLOCK_MOON_NEW,
+    AXISCLOCK_MOON_FIRST_QUARTER,
+    AXISCLOCK_MOON_FULL,
+    AXISCLOCK_MOON_LAST_QUARTER
+} AxisClockMoonQuarter;
+
+/**
+ * AxisClockAstroMonth:
+ * @first_day: Day number (days since 1970-01-01) of cell 0
+ * @latitude: Degrees, north positive
+ * @longitude: Degrees, east positive
+ * @sunrise: Local minutes after midnight, negative if the sun does not rise or set
+ * @sunset: Local minutes after midnight, negative if the sun does not rise or set
+ * @moon_age: Mean days since new moon at local noon
+ * @moon_quarter: #AxisClockMoonQuarter reached during each day
+ *
+ * Astronomical values for every cell of one calendar page.
+ */
+typedef struct _AxisClockAstroMonth {
+    gint32  first_day;
+    gdouble latitude;
+    gdouble longitude;
+    gdouble sunrise[AXISCLOCK_ASTRO_CELLS];
+    gdouble sunset[AXISCLOCK_ASTRO_CELLS];
+    gdouble moon_age[AXISCLOCK_ASTRO_CELLS];
+    gint8   moon_quarter[AXISCLOCK_ASTRO_CELLS];
+} AxisClockAstroMonth;
+
+/*
+ * All 42 cells are computed in one pass over plain arrays and the result is
+ * cached per (page, location), so paging back and forth costs nothing.
+ */
+const AxisClockAstroMonth *axisclock_astro_get_month   (gint32                     first_day,
+                                                        gdouble                    latitude,
+                                                        gdouble                    longitude);
+const gchar               *axisclock_astro_phase_name  (gdouble                    moon_age);
+const gchar               *axisclock_astro_quarter_symbol (AxisClockMoonQuarter    quarter);
+
+G_END_DECLS
+
+#endif /* !__ASTRO_H__ */
@@ -28,12 +28,20 @@
 #include <gtk/gtk.h>
 #include <time.h>
 #include "calendar_popup.h"
+#include "astro.h"
+#include "date_utils.h"
+#include "holidays.h"
+#include "locale_cache.h"
+#include "profiler.h"
 
 /* Forward declarations */
 static void update_calendar(AxisClockCalendar *calendar);
 static gboolean on_draw(GtkWidget *widget, cairo_t *cr, gpointer user_data);
 static gboolean on_button_press(GtkWidget *widget, GdkEventButton *event, gpointer user_data);
 static gboolean on_focus_out(GtkWidget *widget, GdkEventFocus *event, gpointer user_data);
+static gboolean on_scroll(GtkWidget *widget, GdkEventScroll *event, gpointer user_data);
+static void on_prev_clicked(GtkButton *button, gpointer user_data);
+static void on_next_clicked(GtkButton *button, gpointer user_data);
 
 /* Create a new calendar popup */
 AxisClockCalendar *
@@ -96,12 +104,30 @@ axisclock_calendar_new(GtkWidget *parent)
     g_signal_connect(calendar->window, "draw", G_CALLBACK(on_draw), calendar);
     g_signal_connect(calendar->window, "button-press-event", G_CALLBACK(on_button_press), calendar);
     g_signal_connect(calendar->window, "focus-out-event", G_CALLBACK(on_focus_out), calendar);
+    gtk_widget_add_events(calendar->window, GDK_SCROLL_MASK);
+    g_signal_connect(calendar->window, "scroll-event", G_CALLBACK(on_scroll), calendar);
 
     /* Main container */
     GtkWidget *vbox = gtk_box_new(GTK_ORIENTATION_VERTICAL, 2);
     gtk_container_set_border_width(GTK_CONTAINER(vbox), 8);
     gtk_container_add(GTK_CONTAINER(calendar->window), vbox);
 
+    /* Month heading with paging buttons */
+    GtkWidget *header = gtk_box_new(GTK_ORIENTATION_HORIZONTAL, 0);
+    GtkWidget *button = gtk_button_new_from_icon_name("go-previous-symbolic", GTK_ICON_SIZE_MENU);
+    gtk_button_set_relief(GTK_BUTTON(button), GTK_RELIEF_NONE);
+    g_signal_connect(button, "clicked", G_CALLBACK(on_prev_clicked), calendar);
+    gtk_box_pack_start(GTK_BOX(header), button, FALSE, FALSE, 0);
+    
+    calendar->title_label = gtk_label_new("");
+    gtk_box_pack_start(GTK_BOX(header), calendar->title_label, TRUE, TRUE, 0);
+    
+    button = gtk_button_new_from_icon_name("go-next-symbolic", GTK_ICON_SIZE_MENU);
+    gtk_button_set_relief(GTK_BUTTON(button), GTK_RELIEF_NONE);
+    g_signal_connect(button, "clicked", G_CALLBACK(on_next_clicked), calendar);
+    gtk_box_pack_end(GTK_BOX(header), button, FALSE, FALSE, 0);
+    gtk_box_pack_start(GTK_BOX(vbox), header, FALSE, FALSE, 0);
+    
     /* Add grid for calendar days */
     calendar->grid = gtk_grid_new();
     gtk_grid_set_row_homogeneous(GTK_GRID(calendar->grid), TRUE);
@@ -110,26 +136,58 @@ axisclock_calendar_new(GtkWidget *parent)
     gtk_grid_set_column_spacing(GTK_GRID(calendar->grid), 2);
     gtk_box_pack_start(GTK_BOX(vbox), calendar->grid, TRUE, TRUE, 0);
 
-    /* Day names */
-    const gchar *day_names[] = {"S", "M", "T", "W", "T", "F", "S"};
+    /* Day names, filled from the locale snapshot by update_calendar() */
     for (int i = 0; i < 7; ++i) {
-        GtkWidget *label = gtk_label_new(day_names[i]);
-        gtk_grid_attach(GTK_GRID(calendar->grid), label, i, 0, 1, 1);
+        calendar->day_name_labels[i] = gtk_label_new("");
+        gtk_grid_attach(GTK_GRID(calendar->grid), calendar->day_name_labels[i], i, 0, 1, 1);
     }
 
+    /* ISO week numbers in a column left of the days, hidden by default */
+    for (int i = 0; i < 6; ++i) {
+        calendar->week_labels[i] = gtk_label_new("");
+        gtk_style_context_add_class(gtk_widget_get_style_context(calendar->week_labels[i]), "dim-label");
+        gtk_widget_set_no_show_all(calendar->week_labels[i], TRUE);
+        gtk_grid_attach(GTK_GRID(calendar->grid), calendar->week_labels[i], -1, i + 1, 1, 1);
+    }
+    
     /* Create labels for the days */
     for (int i = 0; i < 42; ++i) {
         calendar->day_buttons[i] = gtk_label_new("");
         gtk_widget_set_size_request(calendar->day_buttons[i], 30, 30);
+        gtk_label_set_justify(GTK_LABEL(calendar->day_buttons[i]), GTK_JUSTIFY_CENTER);
         gtk_grid_attach(GTK_GRID(calendar->grid), calendar->day_buttons[i], i % 7, (i / 7) + 1, 1, 1);
     }
 
+    /* Additional time zones below the grid */
+    calendar->zones_label = gtk_label_new("");
+    gtk_label_set_justify(GTK_LABEL(calendar->zones_label), GTK_JUSTIFY_CENTER);
+    gtk_widget_set_no_show_all(calendar->zones_label, TRUE);
+    gtk_box_pack_start(GTK_BOX(vbox), calendar->zones_label, FALSE, FALSE, 4);
+    
+    /* Today's sunrise, sunset and moon phase, hidden unless enabled */
+    calendar->astro_label = gtk_label_new("");
+    gtk_label_set_justify(GTK_LABEL(calendar->astro_label), GTK_JUSTIFY_CENTER);
+    gtk_widget_set_no_show_all(calendar->astro_label, TRUE);
+    gtk_box_pack_start(GTK_BOX(vbox), calendar->astro_label, FALSE, FALSE, 4);
+    
     /* Update the calendar */
     update_calendar(calendar);
 
     return calendar;
 }
 
+/* Cache the window's background and border colors */
+static void
+read_theme_colors(AxisClockCalendar *calendar)
+{
+    GtkStyleContext *context = gtk_widget_get_style_context(calendar->window);
+    GtkStateFlags state = gtk_widget_get_state_flags(calendar->window);
+    
+    gtk_style_context_get_background_color(context, state, &calendar->bg_color);
+    gtk_style_context_get_border_color(context, state, &calendar->border_color);
+    calendar->colors_valid = TRUE;
+}
+
 /* Custom draw callback for transparency and rounded corners */
 static gboolean
 on_draw(GtkWidget *widget, cairo_t *cr, gpointer user_data)
@@ -138,13 +196,13 @@ on_draw(GtkWidget *widget, cairo_t *cr, gpointer user_data)
     gint width = gtk_widget_get_allocated_width(widget);
     gint height = gtk_widget_get_allocated_height(widget);
     double radius = 12.0;
-    GtkStyleContext *context;
-    GdkRGBA bg_color, border_color;
     
-    /* Get colors from the system theme */
-    context = gtk_widget_get_style_context(widget);
-    gtk_style_context_get_background_color(context, gtk_widget_get_state_flags(widget), &bg_color);
-    gtk_style_context_get_border_color(context, gtk_widget_get_state_flags(widget), &border_color);
+    AXISCLOCK_PROBE_BEGIN(probe_start);
+    AXISCLOCK_COUNT(AXISCLOCK_COUNTER_RENDERS);
+    
+    /* Colors from the system theme, cached until the style changes */
+    if (!calendar->colors_valid)
+        read_theme_colors(calendar);
     
     /* Clear the surface */
     cairo_set_source_rgba(cr, 0.0, 0.0, 0.0, 0.0);
@@ -160,68 +218,172 @@ on_draw(GtkWidget *widget, cairo_t *cr, gpointer user_data)
     cairo_close_path(cr);
     
     /* Fill with semi-transparent theme background color */
-    cairo_set_source_rgba(cr, bg_color.red, bg_color.green, bg_color.blue, calendar->transparency);
+    cairo_set_source_rgba(cr, calendar->bg_color.red, calendar->bg_color.green, calendar->bg_color.blue,
+                          calendar->transparency);
     cairo_fill_preserve(cr);
     
     /* Add a subtle border using theme border color */
-    cairo_set_source_rgba(cr, border_color.red, border_color.green, border_color.blue, calendar->transparency);
+    cairo_set_source_rgba(cr, calendar->border_color.red, calendar->border_color.green, calendar->border_color.blue,
+                          calendar->transparency);
     cairo_set_line_width(cr, 1.0);
     cairo_stroke(cr);
     
     /* Let child widgets draw themselves */
     cairo_set_operator(cr, CAIRO_OPERATOR_OVER);
+    
+    AXISCLOCK_PROBE_END(AXISCLOCK_PROBE_DRAW, probe_start);
+#ifdef AXISCLOCK_ENABLE_PROFILING
+    if (calendar->show_started != 0) {
+        axisclock_profiler_record(AXISCLOCK_PROBE_POPUP_LATENCY, calendar->show_started);
+        calendar->show_started = 0;
+    }
+#endif
     return FALSE;
 }
 
+/* Sunrise, sunset and moon phase of one cell */
+static gchar *
+astro_describe(const AxisClockAstroMonth *astro, gint cell)
+{
+    const gchar *phase = axisclock_astro_phase_name(astro->moon_age[cell]);
+    gint rise = (gint)(astro->sunrise[cell] + 0.5);
+    gint set = (gint)(astro->sunset[cell] + 0.5);
+    
+    if (astro->sunrise[cell] < 0.0)
+        return g_strdup_printf("No sunrise or sunset\n%s", phase);
+    
+    return g_strdup_printf("Sunrise %02d:%02d, sunset %02d:%02d\n%s",
+                           rise / 60 % 24, rise % 60, set / 60 % 24, set % 60, phase);
+}
+
 static void
 update_calendar(AxisClockCalendar *calendar)
 {
+    const AxisClockLocale *locale = axisclock_locale_get();
+    gchar *title;
+    
+    AXISCLOCK_PROBE_BEGIN(probe_start);
 
-    /* Calculate first day of the month */
-    struct tm tm = {0};
-    tm.tm_year = calendar->current_year - 1900;
-    tm.tm_mon = calendar->current_month;
-    tm.tm_mday = 1;
-    mktime(&tm);
-    
-    /* tm_wday: 0 = Sunday, 1 = Monday, ..., 6 = Saturday */
-    int start_day_of_week = tm.tm_wday;
-    
-    /* Get number of days in current month */
-    int days_in_month;
-    if (calendar->current_month == 1) { /* February */
-        /* Check for leap year */
-        if ((calendar->current_year % 4 == 0 && calendar->current_year % 100 != 0) || 
-            (calendar->current_year % 400 == 0)) {
-            days_in_month = 29;
-        } else {
-            days_in_month = 28;
+    /* Header row follows the locale's first weekday */
+    if (calendar->locale_serial != locale->serial) {
+        for (int i = 0; i < 7; ++i) {
+            gtk_label_set_text(GTK_LABEL(calendar->day_name_labels[i]),
+                               locale->day_initial[(locale->first_weekday + i) % 7].text);
         }
-    } else if (calendar->current_month == 3 || calendar->current_month == 5 || 
-               calendar->current_month == 8 || calendar->current_month == 10) {
-        days_in_month = 30;
-    } else {
-        days_in_month = 31;
+        calendar->locale_serial = locale->serial;
     }
+    
+    title = g_strdup_printf("%s %d", locale->mon_standalone[calendar->current_month].text,
+                            calendar->current_year);
+    gtk_label_set_text(GTK_LABEL(calendar->title_label), title);
+    g_free(title);
+    
+    /* First weekday and length of the month */
+    gint year = calendar->current_year;
+    gint month = calendar->current_month + 1;
+    gint first_day = axisclock_date_to_days(year, month, 1);
+    
+    /* 0 = Sunday, 1 = Monday, ..., 6 = Saturday */
+    int start_day_of_week = (axisclock_date_weekday(first_day) - locale->first_weekday + 7) % 7;
+    int days_in_month = axisclock_date_days_in_month(year, month);
+    int today = -1;
+    guint32 event_mask = 0;
+    guint32 holiday_mask;
+    const AxisClockAstroMonth *astro = NULL;
+    const AxisClockSecondaryMonth *secondary;
+    
+    if (calendar->current_month == calendar->today_month && calendar->current_year == calendar->today_year)
+        today = calendar->today_day;
+    if (calendar->events != NULL)
+        event_mask = axisclock_events_get_month_mask(calendar->events, year, month);
+    holiday_mask = axisclock_holidays_get_month_mask(calendar->holiday_country, year, month);
+    
+    /* ISO week of each row's Monday; rows without days of the month stay blank */
+    for (int row = 0; row < 6; ++row) {
+        gint monday = row * 7 + (1 - locale->first_weekday + 7) % 7;
+        gchar week[4] = "";
+        
+        if (row * 7 < start_day_of_week + days_in_month)
+            g_snprintf(week, sizeof(week), "%d",
+                       axisclock_date_iso_week(first_day - start_day_of_week + monday));
+        gtk_label_set_text(GTK_LABEL(calendar->week_labels[row]), week);
+    }
+    
+    /* The whole page at once, cached; cells below only read it */
+    if (calendar->show_astro)
+        astro = axisclock_astro_get_month(first_day - start_day_of_week,
+                                          calendar->latitude, calendar->longitude);
+    gtk_widget_set_visible(calendar->astro_label, FALSE);
+    secondary = axisclock_calendar_system_get_month(calendar->secondary_calendar, first_day - start_day_of_week);
 
     /* Fill the calendar grid with days */
     for (int i = 0; i < 42; ++i) {
         if (i >= start_day_of_week && i < start_day_of_week + days_in_month) {
             int day = i - start_day_of_week + 1;
-            gchar *day_label = g_strdup_printf("%d", day);
-            gtk_label_set_text(GTK_LABEL(calendar->day_buttons[i]), day_label);
-            g_free(day_label);
-
-            /* Highlight today's date */
-            if (day == calendar->today_day && calendar->current_month == calendar->today_month && calendar->current_year == calendar->today_year) {
-                gchar *markup = g_strdup_printf("<b>%d</b>", day);
-                gtk_label_set_markup(GTK_LABEL(calendar->day_buttons[i]), markup);
-                g_free(markup);
+            gboolean has_event = (event_mask & (1u << (day - 1))) != 0;
+            gboolean is_holiday = (holiday_mask & (1u << (day - 1))) != 0;
+            const gchar *moon = astro != NULL ? axisclock_astro_quarter_symbol(astro->moon_quarter[i]) : NULL;
+            const gchar *holiday = NULL;
+            const gchar *tooltip[4];
+            guint n_tooltip = 0;
+            gchar *astro_text = NULL;
+            gchar day_label[192];
+            
+            /* Today is bold, holidays are red, days with events are
+             * underlined, moon quarters get a glyph */
+            g_snprintf(day_label, sizeof(day_label), "%s%s%s%d%s%s%s",
+                       is_holiday ? "<span foreground=\"#e01b24\">" : "",
+                       day == today ? "<b>" : "", has_event ? "<u>" : "", day,
+                       has_event ? "</u>" : "", day == today ? "</b>" : "",
+                       is_holiday ? "</span>" : "");
+            if (moon != NULL) {
+                g_strlcat(day_label, "<small>", sizeof(day_label));
+                g_strlcat(day_label, moon, sizeof(day_label));
+                g_strlcat(day_label, "</small>", sizeof(day_label));
             }
+            if (secondary != NULL && secondary->cell[i][0] != '\0') {
+                g_strlcat(day_label, "\n<small>", sizeof(day_label));
+                g_strlcat(day_label, secondary->cell[i], sizeof(day_label));
+                g_strlcat(day_label, "</small>", sizeof(day_label));
+            }
+            gtk_label_set_markup(GTK_LABEL(calendar->day_buttons[i]), day_label);
+            
+            if (is_holiday)
+                holiday = axisclock_holidays_get_name(calendar->holiday_country, year, month, day);
+            
+            if (astro != NULL) {
+                astro_text = astro_describe(astro, i);
+                if (day == today) {
+                    gtk_label_set_text(GTK_LABEL(calendar->astro_label), astro_text);
+                    gtk_widget_set_visible(calendar->astro_label, TRUE);
+                }
+            }
+            
+            /* Holiday, secondary date and sun times, one per line */
+            if (holiday != NULL)
+                tooltip[n_tooltip++] = holiday;
+            if (secondary != NULL && secondary->description[i][0] != '\0')
+                tooltip[n_tooltip++] = secondary->description[i];
+            if (astro_text != NULL)
+                tooltip[n_tooltip++] = astro_text;
+            tooltip[n_tooltip] = NULL;
+            
+            if (n_tooltip > 1) {
+                gchar *text = g_strjoinv("\n", (gchar **)tooltip);
+                
+                gtk_widget_set_tooltip_text(calendar->day_buttons[i], text);
+                g_free(text);
+            } else {
+                gtk_widget_set_tooltip_text(calendar->day_buttons[i], tooltip[0]);
+            }
+            g_free(astro_text);
         } else {
             gtk_label_set_text(GTK_LABEL(calendar->day_buttons[i]), "");
+            gtk_widget_set_tooltip_text(calendar->day_buttons[i], NULL);
         }
     }
+    
+    AXISCLOCK_PROBE_END(AXISCLOCK_PROBE_UPDATE_CALENDAR, probe_start);
 }
 
 
@@ -234,13 +396,35 @@ axisclock_calendar_show(AxisClockCalendar *calendar)
     GdkMonitor *monitor;
     GdkRectangle workarea;
     gint x, y, width, height;
-    gint popup_width = 240, popup_height = 240;
+    GtkRequisition natural;
+    gint popup_width, popup_height;
     gint final_x, final_y;
+    time_t t;
+    struct tm tm_info;
+    
+    AXISCLOCK_PROBE_STAMP(calendar->show_started);
+    AXISCLOCK_PROBE_BEGIN(probe_start);
+    
+    /* Always open on today's month */
+    t = time(NULL);
+    localtime_r(&t, &tm_info);
+    calendar->today_day = tm_info.tm_mday;
+    calendar->today_month = tm_info.tm_mon;
+    calendar->today_year = tm_info.tm_year + 1900;
+    calendar->current_month = calendar->today_month;
+    calendar->current_year = calendar->today_year;
+    update_calendar(calendar);
     
     /* First realize the window to get its actual size */
     gtk_widget_realize(calendar->window);
     gtk_widget_show_all(calendar->window);
     
+    /* Position from the real size: calendar-system dates under the days
+     * make the popup larger than the plain grid */
+    gtk_widget_get_preferred_size(calendar->window, NULL, &natural);
+    popup_width = natural.width;
+    popup_height = natural.height;
+    
     /* Get parent widget position and size */
     window = gtk_widget_get_window(calendar->parent_widget);
     if (!window) return;
@@ -285,6 +469,8 @@ axisclock_calendar_show(AxisClockCalendar *calendar)
     /* Grab focus so we can detect when user clicks outside */
     gtk_widget_grab_focus(calendar->window);
     gtk_window_present(GTK_WINDOW(calendar->window));
+    
+    AXISCLOCK_PROBE_END(AXISCLOCK_PROBE_CALENDAR_SHOW, probe_start);
 }
 
 /* Hide the calendar popup */
@@ -298,6 +484,8 @@ axisclock_calendar_hide(AxisClockCalendar *calendar)
 void
 axisclock_calendar_destroy(AxisClockCalendar *calendar)
 {
+    axisclock_events_free(calendar->events);
+    g_free(calendar->holiday_country);
     gtk_widget_destroy(calendar->window);
     g_free(calendar);
 }
@@ -317,6 +505,111 @@ axisclock_calendar_set_transparency(AxisClockCalendar *calendar, gdouble transpa
     }
 }
 
+/* Read the theme colors of the background again and redraw */
+void
+axisclock_calendar_reload_style(AxisClockCalendar *calendar)
+{
+    g_return_if_fail(calendar != NULL);
+    
+    read_theme_colors(calendar);
+    
+    if (gtk_widget_get_visible(calendar->window))
+        gtk_widget_queue_draw(calendar->window);
+}
+
+/* Set the additional time zones text; NULL or empty hides it */
+void
+axisclock_calendar_set_zones_text(AxisClockCalendar *calendar, const gchar *text)
+{
+    g_return_if_fail(calendar != NULL);
+    
+    if (text == NULL || *text == '\0') {
+        gtk_widget_hide(calendar->zones_label);
+        return;
+    }
+    
+    gtk_label_set_text(GTK_LABEL(calendar->zones_label), text);
+    gtk_widget_show(calendar->zones_label);
+}
+
+/* Show or hide the ISO week number column */
+void
+axisclock_calendar_set_week_numbers(AxisClockCalendar *calendar, gboolean show)
+{
+    g_return_if_fail(calendar != NULL);
+    
+    for (int i = 0; i < 6; ++i)
+        gtk_widget_set_visible(calendar->week_labels[i], show);
+}
+
+/* Mark public holidays of a country (ISO 3166 code); NULL or "" disables */
+void
+axisclock_calendar_set_holidays(AxisClockCalendar *calendar, const gchar *country)
+{
+    g_return_if_fail(calendar != NULL);
+    
+    g_free(calendar->holiday_country);
+    calendar->holiday_country = g_strdup(country);
+    
+    if (gtk_widget_get_visible(calendar->window))
+        update_calendar(calendar);
+}
+
+/* Show dates of another calendar system under the Gregorian days */
+void
+axisclock_calendar_set_secondary_calendar(AxisClockCalendar *calendar, AxisClockCalendarSystem system)
+{
+    g_return_if_fail(calendar != NULL);
+    
+    calendar->secondary_calendar = system;
+    
+    if (gtk_widget_get_visible(calendar->window))
+        update_calendar(calendar);
+}
+
+/* Enable sun and moon annotations for a location */
+void
+axisclock_calendar_set_location(AxisClockCalendar *calendar, gboolean enabled,
+                                gdouble latitude, gdouble longitude)
+{
+    g_return_if_fail(calendar != NULL);
+    
+    calendar->show_astro = enabled;
+    calendar->latitude = CLAMP(latitude, -90.0, 90.0);
+    calendar->longitude = CLAMP(longitude, -180.0, 180.0);
+    
+    if (gtk_widget_get_visible(calendar->window))
+        update_calendar(calendar);
+}
+
+/* An event file changed; redraw the month if it is on screen */
+static void
+on_events_changed(AxisClockEvents *events G_GNUC_UNUSED, gpointer user_data)
+{
+    AxisClockCalendar *calendar = user_data;
+    
+    if (gtk_widget_get_visible(calendar->window))
+        update_calendar(calendar);
+}
+
+/* Replace the .ics files whose events are marked; NULL or empty disables */
+void
+axisclock_calendar_set_event_sources(AxisClockCalendar *calendar, const gchar * const *paths)
+{
+    g_return_if_fail(calendar != NULL);
+    
+    axisclock_events_free(calendar->events);
+    calendar->events = NULL;
+    
+    if (paths != NULL && paths[0] != NULL) {
+        calendar->events = axisclock_events_new(paths);
+        axisclock_events_set_changed_callback(calendar->events, on_events_changed, calendar);
+    }
+    
+    if (gtk_widget_get_visible(calendar->window))
+        update_calendar(calendar);
+}
+
 /* Handle button press events */
 static gboolean
 on_button_press(GtkWidget *widget, GdkEventButton *event, gpointer user_data)
@@ -326,6 +619,48 @@ on_button_press(GtkWidget *widget, GdkEventButton *event, gpointer user_data)
     return FALSE;
 }
 
+/* Move the view by @delta months */
+static void
+calendar_page(AxisClockCalendar *calendar, gint delta)
+{
+    gint month = calendar->current_year * 12 + calendar->current_month + delta;
+    
+    calendar->current_year = month / 12;
+    calendar->current_month = month % 12;
+    update_calendar(calendar);
+}
+
+/* Previous month button */
+static void
+on_prev_clicked(GtkButton *button G_GNUC_UNUSED, gpointer user_data)
+{
+    calendar_page((AxisClockCalendar *)user_data, -1);
+}
+
+/* Next month button */
+static void
+on_next_clicked(GtkButton *button G_GNUC_UNUSED, gpointer user_data)
+{
+    calendar_page((AxisClockCalendar *)user_data, 1);
+}
+
+/* Scroll to page through months */
+static gboolean
+on_scroll(GtkWidget *widget G_GNUC_UNUSED, GdkEventScroll *event, gpointer user_data)
+{
+    AxisClockCalendar *calendar = (AxisClockCalendar *)user_data;
+    
+    if (event->direction == GDK_SCROLL_UP) {
+        calendar_page(calendar, -1);
+        return TRUE;
+    } else if (event->direction == GDK_SCROLL_DOWN) {
+        calendar_page(calendar, 1);
+        return TRUE;
+    }
+    
+    return FALSE;
+}
+
 /* Handle focus out events - hide calendar when it loses focus */
 static gboolean
 on_focus_out(GtkWidget *widget, GdkEventFocus *event, gpointer user_data)
@@ -26,6 +26,8 @@
 
 #include <gtk/gtk.h>
 #include <time.h>
+#include "calendar_systems.h"
+#include "ics_events.h"
 
 G_BEGIN_DECLS
 
@@ -33,6 +35,9 @@ G_BEGIN_DECLS
 typedef struct _AxisClockCalendar {
     GtkWidget *window;          /* Main popup window */
     GtkWidget *grid;            /* Calendar grid */
+    GtkWidget *title_label;     /* Month and year heading */
+    GtkWidget *day_name_labels[7];
+    guint locale_serial;        /* Locale snapshot the header shows */
     
     /* Calendar state */
     gint current_year;
@@ -41,14 +46,43 @@ typedef struct _AxisClockCalendar {
     gint today_month;
     gint today_year;
     
+    /* Additional time zones, hidden when empty */
+    GtkWidget *zones_label;
+    
+    /* Days with local calendar events, NULL when none configured */
+    AxisClockEvents *events;
+    
+    /* Sunrise, sunset and moon phases for a location */
+    gboolean show_astro;
+    gdouble latitude;
+    gdouble longitude;
+    GtkWidget *astro_label;
+    
     /* Day buttons array - 6 weeks x 7 days */
     GtkWidget *day_buttons[42];
     
+    /* ISO week number of each row */
+    GtkWidget *week_labels[6];
+    
+    /* ISO 3166 code of the country whose holidays are marked, or NULL */
+    gchar *holiday_country;
+    
+    /* Calendar system shown under each day, NONE for Gregorian only */
+    AxisClockCalendarSystem secondary_calendar;
+    
     /* Parent widget for positioning */
     GtkWidget *parent_widget;
     
     /* Transparency level (0.0 - 1.0) */
     gdouble transparency;
+    
+    /* Theme colors of the background, read again only on style changes */
+    GdkRGBA bg_color;
+    GdkRGBA border_color;
+    gboolean colors_valid;
+    
+    /* Profiler timestamp of the last show, cleared by the first draw */
+    gint64 show_started;
 } AxisClockCalendar;
 
 /* Function prototypes */
@@ -57,6 +91,14 @@ void axisclock_calendar_show(AxisClockCalendar *calendar);
 void axisclock_calendar_hide(AxisClockCalendar *calendar);
 void axisclock_calendar_destroy(AxisClockCalendar *calendar);
 void axisclock_calendar_set_transparency(AxisClockCalendar *calendar, gdouble transparency);
+void axisclock_calendar_reload_style(AxisClockCalendar *calendar);
+void axisclock_calendar_set_zones_text(AxisClockCalendar *calendar, const gchar *text);
+void axisclock_calendar_set_event_sources(AxisClockCalendar *calendar, const gchar * const *paths);
+void axisclock_calendar_set_week_numbers(AxisClockCalendar *calendar, gboolean show);
+void axisclock_calendar_set_holidays(AxisClockCalendar *calendar, const gchar *country);
+void axisclock_calendar_set_secondary_calendar(AxisClockCalendar *calendar, AxisClockCalendarSystem system);
+void axisclock_calendar_set_location(AxisClockCalendar *calendar, gboolean enabled,
+                                     gdouble latitude, gdouble longitude);
 
 G_END_DECLS
 
@@ -0,0 +1,480 @@
+/*
+ * xfce4-axisclock-plugin - A macOS-style clock plugin for the Xfce panel
+ *
+ * Copyright (c) 2025 Kamil 'Novik' Nowicki <novik@axisos.org>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Website: https://axisos.org
+ * Repository: https://github.com/AxisOS/xfce4-axisclock-plugin
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <glib.h>
+
+#include "calendar_systems.h"
+#include "date_utils.h"
+#include "profiler.h"
+
+/* Pages kept, enough to page back and forth around the current month */
+#define SECONDARY_CACHE_SIZE 4
+
+/* Position in a secondary calendar while walking a page */
+typedef struct {
+    gint     year;
+    gint     month;             /* 1-based, in the system's own order */
+    gint     day;
+    gint     month_length;
+    gboolean leap_month;        /* Chinese intercalary month */
+    gint32   year_length;       /* Hebrew only */
+} SecondaryDate;
+
+/* Conversion kernel of one calendar system */
+typedef struct {
+    const gchar *name;
+    gboolean   (*locate)     (gint32 first_day, SecondaryDate *date);
+    void       (*next_month) (SecondaryDate *date);
+    void       (*describe)   (const SecondaryDate *date, gchar *cell, gsize cell_size,
+                              gchar *description, gsize description_size);
+} CalendarKernel;
+
+static AxisClockSecondaryMonth secondary_cache[SECONDARY_CACHE_SIZE];
+static gboolean secondary_cache_valid[SECONDARY_CACHE_SIZE];
+static guint secondary_cache_next;
+
+/* ---- Tabular Islamic ---------------------------------------------------- */
+
+/* 1 Muharram 1 AH, 16 July 622 (Julian) */
+#define HIJRI_EPOCH (-492148)
+
+/* Start of each year in the 30-year cycle; leap years 2, 5, 7, 10, 13, 16,
+ * 18, 21, 24, 26 and 29 have 355 days */
+static const guint16 hijri_year_starts[31] = {
+    0, 354, 709, 1063, 1417, 1772, 2126, 2481, 2835, 3189, 3544, 3898, 4252, 4607, 4961, 5315,
+    5670, 6024, 6379, 6733, 7087, 7442, 7796, 8150, 8505, 8859, 9214, 9568, 9922, 10277, 10631
+};
+
+/* Months alternate between 30 and 29 days */
+static const guint16 hijri_month_starts[12] = {
+    0, 30, 59, 89, 118, 148, 177, 207, 236, 266, 295, 325
+};
+
+static const gchar *const hijri_months[12] = {
+    "Muharram", "Safar", "Rabi' al-awwal", "Rabi' al-thani", "Jumada al-awwal", "Jumada al-thani",
+    "Rajab", "Sha'ban", "Ramadan", "Shawwal", "Dhu al-Qi'dah", "Dhu al-Hijjah"
+};
+
+static const gchar *const hijri_months_short[12] = {
+    "Muh", "Saf", "Rab I", "Rab II", "Jum I", "Jum II", "Raj", "Sha", "Ram", "Shaw", "Qid", "Hij"
+};
+
+static gint
+hijri_month_length(gint year, gint month)
+{
+    gint k = (year - 1) % 30 + 1;
+    
+    if (month == 12)
+        return hijri_year_starts[k] - hijri_year_starts[k - 1] == 355 ? 30 : 29;
+    return month % 2 == 1 ? 30 : 29;
+}
+
+static gboolean
+hijri_locate(gint32 first_day, SecondaryDate *date)
+{
+    gint32 offset = first_day - HIJRI_EPOCH;
+    gint k = 1;
+    
+    if (offset < 0)
+        return FALSE;
+    
+    date->year = offset / hijri_year_starts[30] * 30;
+    offset %= hijri_year_starts[30];
+    while (hijri_year_starts[k] <= offset)
+        k++;
+    date->year += k;
+    offset -= hijri_year_starts[k - 1];
+    
+    date->month = 1;
+    while (date->month < 12 && hijri_month_starts[date->month] <= offset)
+        date->month++;
+    date->day = offset - hijri_month_starts[date->month - 1] + 1;
+    date->month_length = hijri_month_length(date->year, date->month);
+    
+    return TRUE;
+}
+
+static void
+hijri_next_month(SecondaryDate *date)
+{
+    if (++date->month > 12) {
+        date->month = 1;
+        date->year++;
+    }
+    date->month_length = hijri_month_length(date->year, date->month);
+}
+
+static void
+hijri_describe(const SecondaryDate *date, gchar *cell, gsize cell_size, gchar *description, gsize description_size)
+{
+    if (date->day == 1)
+        g_strlcpy(cell, hijri_months_short[date->month - 1], cell_size);
+    else
+        g_snprintf(cell, cell_size, "%d", date->day);
+    g_snprintf(description, description_size, "%d %s %d AH", date->day, hijri_months[date->month - 1], date->year);
+}
+
+/* ---- Hebrew ------------------------------------------------------------- */
+
+/* 1 Tishri AM 1, 7 October 3761 BCE (Julian) */
+#define HEBREW_EPOCH (-2092590)
+
+/* Month lengths in civil order from Tishri, common and leap years;
+ * Heshvan and Kislev are adjusted to the year length */
+static const guint8 hebrew_month_lengths[2][13] = {
+    { 30, 29, 30, 29, 30, 29, 30, 29, 30, 29, 30, 29, 0 },
+    { 30, 29, 30, 29, 30, 30, 29, 30, 29, 30, 29, 30, 29 }
+};
+
+static const gchar *const hebrew_months[2][13] = {
+    { "Tishri", "Heshvan", "Kislev", "Tevet", "Shevat", "Adar", "Nisan", "Iyar", "Sivan",
+      "Tammuz", "Av", "Elul", NULL },
+    { "Tishri", "Heshvan", "Kislev", "Tevet", "Shevat", "Adar I", "Adar II", "Nisan", "Iyar",
+      "Sivan", "Tammuz", "Av", "Elul" }
+};
+
+static gboolean
+hebrew_is_leap_year(gint year)
+{
+    return (7 * year + 1) % 19 < 7;
+}
+
+/* Days from the epoch to the molad of Tishri, with the first postponement */
+static gint32
+hebrew_elapsed_days(gint year)
+{
+    gint64 months = (235 * (gint64)year - 234) / 19;
+    gint64 parts = 12084 + 13753 * months;
+    gint64 days = 29 * months + parts / 25920;
+    
+    if ((3 * (days + 1)) % 7 < 3)
+        days++;
+    return (gint32)days;
+}
+
+/* Day number of 1 Tishri of @year, with the year-length postponements */
+static gint32
+hebrew_new_year(gint year)
+{
+    gint32 previous = hebrew_elapsed_days(year - 1);
+    gint32 current = hebrew_elapsed_days(year);
+    gint32 next = hebrew_elapsed_days(year + 1);
+    gint correction = 0;
+    
+    if (next - current == 356)
+        correction = 2;
+    else if (current - previous == 382)
+        correction = 1;
+    
+    return HEBREW_EPOCH + current + correction;
+}
+
+static gint
+hebrew_month_length(const SecondaryDate *date)
+{
+    if (date->month == 2 && date->year_length % 10 == 5)
+        return 30;
+    if (date->month == 3 && date->year_length % 10 == 3)
+        return 29;
+    return hebrew_month_lengths[hebrew_is_leap_year(date->year)][date->month - 1];
+}
+
+static void
+hebrew_set_year(SecondaryDate *date, gint year)
+{
+    date->year = year;
+    date->year_length = hebrew_new_year(year + 1) - hebrew_new_year(year);
+}
+
+static gboolean
+hebrew_locate(gint32 first_day, SecondaryDate *date)
+{
+    gint gregorian_year, month, day;
+    gint32 offset;
+    
+    /* The year begins in September or October */
+    axisclock_date_from_days(first_day, &gregorian_year, &month, &day);
+    if (gregorian_year < 1)
+        return FALSE;
+    hebrew_set_year(date, gregorian_year + 3761);
+    if (first_day < hebrew_new_year(date->year))
+        hebrew_set_year(date, date->year - 1);
+    
+    offset = first_day - hebrew_new_year(date->year);
+    for (date->month = 1;; date->month++) {
+        date->month_length = hebrew_month_length(date);
+        if (offset < date->month_length)
+            break;
+        offset -= date->month_length;
+    }
+    date->day = offset + 1;
+    
+    return TRUE;
+}
+
+static void
+hebrew_next_month(SecondaryDate *date)
+{
+    if (++date->month > (hebrew_is_leap_year(date->year) ? 13 : 12)) {
+        hebrew_set_year(date, date->year + 1);
+        date->month = 1;
+    }
+    date->month_length = hebrew_month_length(date);
+}
+
+static void
+hebrew_describe(const SecondaryDate *date, gchar *cell, gsize cell_size, gchar *description, gsize description_size)
+{
+    const gchar *name = hebrew_months[hebrew_is_leap_year(date->year)][date->month - 1];
+    
+    if (date->day == 1)
+        g_strlcpy(cell, name, cell_size);
+    else
+        g_snprintf(cell, cell_size, "%d", date->day);
+    g_snprintf(description, description_size, "%d %s %d", date->day, name, date->year);
+}
+
+/* ---- Chinese lunisolar -------------------------------------------------- */
+
+#define CHINESE_FIRST_YEAR 1900
+#define CHINESE_LAST_YEAR  2100
+
+/* Lunar new year 1900, 31 January 1900 */
+#define CHINESE_EPOCH (-25537)
+
+/* Per year: bits 15-4 are months 1-12 (set = 30 days), bits 3-0 the leap
+ * month (0 = none) and bit 16 a 30-day leap month */
+static const guint32 chinese_years[CHINESE_LAST_YEAR - CHINESE_FIRST_YEAR + 1] = {
+    0x04bd8, 0x04ae0, 0x0a570, 0x054d5, 0x0d260, 0x0d950, 0x16554, 0x056a0, 0x09ad0, 0x055d2, /* 1900 */
+    0x04ae0, 0x0a5b6, 0x0a4d0, 0x0d250, 0x1d255, 0x0b540, 0x0d6a0, 0x0ada2, 0x095b0, 0x14977, /* 1910 */
+    0x04970, 0x0a4b0, 0x0b4b5, 0x06a50, 0x06d40, 0x1ab54, 0x02b60, 0x09570, 0x052f2, 0x04970, /* 1920 */
+    0x06566, 0x0d4a0, 0x0ea50, 0x16a95, 0x05ad0, 0x02b60, 0x186e3, 0x092e0, 0x1c8d7, 0x0c950, /* 1930 */
+    0x0d4a0, 0x1d8a6, 0x0b550, 0x056a0, 0x1a5b4, 0x025d0, 0x092d0, 0x0d2b2, 0x0a950, 0x0b557, /* 1940 */
+    0x06ca0, 0x0b550, 0x15355, 0x04da0, 0x0a5b0, 0x14573, 0x052b0, 0x0a9a8, 0x0e950, 0x06aa0, /* 1950 */
+    0x0aea6, 0x0ab50, 0x04b60, 0x0aae4, 0x0a570, 0x05260, 0x0f263, 0x0d950, 0x05b57, 0x056a0, /* 1960 */
+    0x096d0, 0x04dd5, 0x04ad0, 0x0a4d0, 0x0d4d4, 0x0d250, 0x0d558, 0x0b540, 0x0b6a0, 0x195a6, /* 1970 */
+    0x095b0, 0x049b0, 0x0a974, 0x0a4b0, 0x0b27a, 0x06a50, 0x06d40, 0x0af46, 0x0ab60, 0x09570, /* 1980 */
+    0x04af5, 0x04970, 0x064b0, 0x074a3, 0x0ea50, 0x06b58, 0x05ac0, 0x0ab60, 0x096d5, 0x092e0, /* 1990 */
+    0x0c960, 0x0d954, 0x0d4a0, 0x0da50, 0x07552, 0x056a0, 0x0abb7, 0x025d0, 0x092d0, 0x0cab5, /* 2000 */
+    0x0a950, 0x0b4a0, 0x0baa4, 0x0ad50, 0x055d9, 0x04ba0, 0x0a5b0, 0x15176, 0x052b0, 0x0a930, /* 2010 */
+    0x07954, 0x06aa0, 0x0ad50, 0x05b52, 0x04b60, 0x0a6e6, 0x0a4e0, 0x0d260, 0x0ea65, 0x0d530, /* 2020 */
+    0x05aa0, 0x076a3, 0x096d0, 0x04afb, 0x04ad0, 0x0a4d0, 0x1d0b6, 0x0d250, 0x0d520, 0x0dd45, /* 2030 */
+    0x0b5a0, 0x056d0, 0x055b2, 0x049b0, 0x0a577, 0x0a4b0, 0x0aa50, 0x1b255, 0x06d20, 0x0ada0, /* 2040 */
+    0x14b63, 0x09370, 0x049f8, 0x04970, 0x064b0, 0x168a6, 0x0ea50, 0x06b20, 0x1a6c4, 0x0aae0, /* 2050 */
+    0x092e0, 0x0d2e3, 0x0c960, 0x0d557, 0x0d4a0, 0x0da50, 0x05d55, 0x056a0, 0x0a6d0, 0x055d4, /* 2060 */
+    0x052d0, 0x0a9b8, 0x0a950, 0x0b4a0, 0x0b6a6, 0x0ad50, 0x055a0, 0x0aba4, 0x0a5b0, 0x052b0, /* 2070 */
+    0x0b273, 0x06930, 0x07337, 0x06aa0, 0x0ad50, 0x14b55, 0x04b60, 0x0a570, 0x054e4, 0x0d160, /* 2080 */
+    0x0e968, 0x0d520, 0x0daa0, 0x16aa6, 0x056d0, 0x04ae0, 0x0a9d4, 0x0a2d0, 0x0d150, 0x0f252, /* 2090 */
+    0x0d520                                                                                    /* 2100 */
+};
+
+/* Day number of each lunar new year, filled on first use */
+static gint32 chinese_year_starts[CHINESE_LAST_YEAR - CHINESE_FIRST_YEAR + 2];
+
+static const gchar *const chinese_animals[12] = {
+    "Rat", "Ox", "Tiger", "Rabbit", "Dragon", "Snake",
+    "Horse", "Goat", "Monkey", "Rooster", "Dog", "Pig"
+};
+
+static gint
+chinese_leap_month(gint year)
+{
+    return chinese_years[year - CHINESE_FIRST_YEAR] & 0xf;
+}
+
+static gint
+chinese_month_length(gint year, gint month, gboolean leap)
+{
+    guint32 info = chinese_years[year - CHINESE_FIRST_YEAR];
+    
+    if (leap)
+        return (info & 0x10000) ? 30 : 29;
+    return (info & (0x10000 >> month)) ? 30 : 29;
+}
+
+static void
+chinese_build_year_starts(void)
+{
+    chinese_year_starts[0] = CHINESE_EPOCH;
+    
+    for (gint year = CHINESE_FIRST_YEAR; year <= CHINESE_LAST_YEAR; year++) {
+        gint length = 0;
+        
+        for (gint month = 1; month <= 12; month++)
+            length += chinese_month_length(year, month, FALSE);
+        if (chinese_leap_month(year) != 0)
+            length += chinese_month_length(year, 0, TRUE);
+        
+        chinese_year_starts[year - CHINESE_FIRST_YEAR + 1] = chinese_year_starts[year - CHINESE_FIRST_YEAR] + length;
+    }
+}
+
+static gboolean
+chinese_locate(gint32 first_day, SecondaryDate *date)
+{
+    gint last = CHINESE_LAST_YEAR - CHINESE_FIRST_YEAR;
+    gint index;
+    gint32 offset;
+    
+    if (chinese_year_starts[0] == 0)
+        chinese_build_year_starts();
+    
+    /* The whole page has to fit in the table */
+    if (first_day < chinese_year_starts[0] ||
+        first_day + AXISCLOCK_SECONDARY_CELLS > chinese_year_starts[last + 1])
+        return FALSE;
+    
+    for (index = last; chinese_year_starts[index] > first_day; index--)
+        ;
+    date->year = CHINESE_FIRST_YEAR + index;
+    offset = first_day - chinese_year_starts[index];
+    
+    date->month = 1;
+    date->leap_month = FALSE;
+    for (;;) {
+        date->month_length = chinese_month_length(date->year, date->month, date->leap_month);
+        if (offset < date->month_length)
+            break;
+        offset -= date->month_length;
+        
+        /* The leap month follows the regular month of the same number */
+        if (!date->leap_month && chinese_leap_month(date->year) == date->month) {
+            date->leap_month = TRUE;
+        } else {
+            date->leap_month = FALSE;
+            date->month++;
+        }
+    }
+    date->day = offset + 1;
+    
+    return TRUE;
+}
+
+static void
+chinese_next_month(SecondaryDate *date)
+{
+    if (!date->leap_month && chinese_leap_month(date->year) == date->month) {
+        date->leap_month = TRUE;
+    } else {
+        date->leap_month = FALSE;
+        if (++date->month > 12) {
+            date->month = 1;
+            date->year++;
+        }
+    }
+    date->month_length = chinese_month_length(date->year, date->month, date->leap_month);
+}
+
+static void
+chinese_describe(const SecondaryDate *date, gchar *cell, gsize cell_size, gchar *description, gsize description_size)
+{
+    if (date->day == 1)
+        g_snprintf(cell, cell_size, "%s%d月", date->leap_month ? "闰" : "", date->month);
+    else
+        g_snprintf(cell, cell_size, "%d", date->day);
+    g_snprintf(description, description_size, "Day %d of %smonth %d, year of the %s", date->day,
+               date->leap_month ? "leap " : "", date->month, chinese_animals[(date->year - 4) % 12]);
+}
+
+/* ------------------------------------------------------------------------ */
+
+static const CalendarKernel kernels[AXISCLOCK_N_CALENDAR_SYSTEMS] = {
+    { "None", NULL, NULL, NULL },
+    { "Islamic (tabular)", hijri_locate, hijri_next_month, hijri_describe },
+    { "Hebrew", hebrew_locate, hebrew_next_month, hebrew_describe },
+    { "Chinese", chinese_locate, chinese_next_month, chinese_describe }
+};
+
+/**
+ * axisclock_calendar_system_get_month:
+ * @system: Calendar system to convert to
+ * @first_day: Day number of the first cell of the page
+ *
+ * Returns: The cached page, computed on first use, or %NULL for
+ * %AXISCLOCK_CALENDAR_SYSTEM_NONE. Valid until the next call.
+ */
+const AxisClockSecondaryMonth *
+axisclock_calendar_system_get_month(AxisClockCalendarSystem system, gint32 first_day)
+{
+    const CalendarKernel *kernel;
+    AxisClockSecondaryMonth *month;
+    SecondaryDate date = { 0 };
+    
+    if (system <= AXISCLOCK_CALENDAR_SYSTEM_NONE || system >= AXISCLOCK_N_CALENDAR_SYSTEMS)
+        return NULL;
+    
+    for (guint i = 0; i < SECONDARY_CACHE_SIZE; i++) {
+        month = &secondary_cache[i];
+        if (secondary_cache_valid[i] && month->system == system && month->first_day == first_day)
+            return month;
+    }
+    
+    AXISCLOCK_PROBE_BEGIN(probe_start);
+    
+    /* Round-robin replacement */
+    month = &secondary_cache[secondary_cache_next];
+    secondary_cache_valid[secondary_cache_next] = TRUE;
+    secondary_cache_next = (secondary_cache_next + 1) % SECONDARY_CACHE_SIZE;
+    
+    month->system = system;
+    month->first_day = first_day;
+    kernel = &kernels[system];
+    
+    if (!kernel->locate(first_day, &date)) {
+        for (guint i = 0; i < AXISCLOCK_SECONDARY_CELLS; i++)
+            month->cell[i][0] = month->description[i][0] = '\0';
+    } else {
+        /* Step between cells only: a page may end on the last day of a
+         * table, and there is no month after it to step into */
+        for (guint i = 0; i < AXISCLOCK_SECONDARY_CELLS; i++) {
+            if (i > 0 && ++date.day > date.month_length) {
+                date.day = 1;
+                kernel->next_month(&date);
+            }
+            kernel->describe(&date, month->cell[i], sizeof(month->cell[i]),
+                             month->description[i], sizeof(month->description[i]));
+        }
+    }
+    
+    AXISCLOCK_PROBE_END(AXISCLOCK_PROBE_SECONDARY_CALENDAR, probe_start);
+    
+    return month;
+}
+
+/**
+ * axisclock_calendar_system_name:
+ * @system: A calendar system
+ *
+ * Returns: Its name for the preferences, or %NULL if @system is invalid.
+ */
+const gchar *
+axisclock_calendar_system_name(AxisClockCalendarSystem system)
+{
+    if (system < AXISCLOCK_CALENDAR_SYSTEM_NONE || system >= AXISCLOCK_N_CALENDAR_SYSTEMS)
+        return NULL;
+    return kernels[system].name;
+}
@@ -0,0 +1,70 @@
+/*
+ * xfce4-axisclock-plugin - A macOS-style clock plugin for the Xfce panel
+ *
+ * Copyright (c) 2025 Kamil 'Novik' Nowicki <novik@axisos.org>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Website: https://axisos.org
+ * Repository: https://github.com/AxisOS/xfce4-axisclock-plugin
+ */
+
+#ifndef __CALENDAR_SYSTEMS_H__
+#define __CALENDAR_SYSTEMS_H__
+
+#include <glib.h>
+
+G_BEGIN_DECLS
+
+/* Cells in the calendar month model, 6 weeks x 7 days */
+#define AXISCLOCK_SECONDARY_CELLS 42
+
+/* Calendar shown next to the Gregorian days of the popup */
+typedef enum {
+    AXISCLOCK_CALENDAR_SYSTEM_NONE,
+    AXISCLOCK_CALENDAR_SYSTEM_HIJRI,    /* Tabular Islamic, civil epoch */
+    AXISCLOCK_CALENDAR_SYSTEM_HEBREW,   /* Arithmetic Hebrew */
+    AXISCLOCK_CALENDAR_SYSTEM_CHINESE,  /* Chinese lunisolar, 1900-2100 */
+    AXISCLOCK_N_CALENDAR_SYSTEMS
+} AxisClockCalendarSystem;
+
+/**
+ * AxisClockSecondaryMonth:
+ * @system: #AxisClockCalendarSystem of the page
+ * @first_day: Day number (days since 1970-01-01) of cell 0
+ * @cell: Short text per cell: the day of the month, or the month's name on its first day; "" outside the supported range
+ * @description: Full date per cell, e.g. "9 Ramadan 1447 AH"
+ *
+ * Secondary dates for every cell of one calendar page.
+ */
+typedef struct _AxisClockSecondaryMonth {
+    AxisClockCalendarSystem system;
+    gint32                  first_day;
+    gchar                   cell[AXISCLOCK_SECONDARY_CELLS][16];
+    gchar                   description[AXISCLOCK_SECONDARY_CELLS][64];
+} AxisClockSecondaryMonth;
+
+/*
+ * Each system converts cell 0 once, using its year and month-start tables,
+ * then walks forward a day at a time. Pages are cached per (system, first
+ * cell), so the popup's labels only copy precomputed strings.
+ */
+const AxisClockSecondaryMonth *axisclock_calendar_system_get_month (AxisClockCalendarSystem system,
+                                                                    gint32                  first_day);
+const gchar                   *axisclock_calendar_system_name      (AxisClockCalendarSystem system);
+
+G_END_DECLS
+
+#endif /* !__CALENDAR_SYSTEMS_H__ */
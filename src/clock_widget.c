@@ -29,38 +29,491 @@
 #include <libxfce4panel/libxfce4panel.h>
 
 #include "clock_widget.h"
+#include "date_utils.h"
 #include "time_formatter.h"
 #include "plugin_config.h"
 #include "calendar_popup.h"
+#include "alarms.h"
+#include "profiler.h"
+#include "tick_service.h"
 
-/* Update the time display */
+/* Layout measurements kept before the cache is emptied */
+#define LAYOUT_CACHE_SIZE 64
+
+/* Horizontal padding around the label, on each side */
+#define LABEL_MARGIN 4
+
+/* Size request of the label for one layout key */
+typedef struct {
+    gint width;
+    gint height;
+} AxisClockLayout;
+
+/* Remember the current font and its widest digit */
+static void
+axisclock_measure_font(AxisClockPlugin *axisclock)
+{
+    PangoContext *context = gtk_widget_get_pango_context(axisclock->label);
+    gint widest = -1;
+    
+    g_free(axisclock->layout_font);
+    axisclock->layout_font = pango_font_description_to_string(pango_context_get_font_description(context));
+    
+    for (gchar digit[2] = "0"; digit[0] <= '9'; digit[0]++) {
+        PangoLayout *layout = gtk_widget_create_pango_layout(axisclock->label, digit);
+        gint width;
+        
+        pango_layout_get_pixel_size(layout, &width, NULL);
+        if (width > widest) {
+            widest = width;
+            axisclock->widest_digit = digit[0];
+        }
+        g_object_unref(layout);
+    }
+}
+
+/* Measure @shape laid out for the current panel mode and size */
+static AxisClockLayout *
+axisclock_measure_layout(AxisClockPlugin *axisclock, const gchar *shape)
+{
+    AxisClockLayout *result = g_new(AxisClockLayout, 1);
+    PangoLayout *layout = gtk_widget_create_pango_layout(axisclock->label, shape);
+    gint available = MAX(axisclock->panel_size - 2 * LABEL_MARGIN, 1);
+    gint width, height;
+    
+    switch (axisclock->mode) {
+    case XFCE_PANEL_PLUGIN_MODE_DESKBAR:
+        /* Stacked: wrapped to the panel width, one line per part */
+        pango_layout_set_width(layout, available * PANGO_SCALE);
+        pango_layout_set_wrap(layout, PANGO_WRAP_WORD);
+        pango_layout_get_pixel_size(layout, NULL, &height);
+        result->width = available;
+        result->height = height;
+        break;
+    case XFCE_PANEL_PLUGIN_MODE_VERTICAL:
+        /* Rotated: the text runs along the panel */
+        pango_layout_get_pixel_size(layout, &width, &height);
+        result->width = height;
+        result->height = width;
+        break;
+    default:
+        pango_layout_get_pixel_size(layout, &width, NULL);
+        result->width = width;
+        result->height = -1;
+        break;
+    }
+    
+    g_object_unref(layout);
+    return result;
+}
+
+/* Pin the label to the cached size of its current layout variant. The key
+ * uses the text with every digit replaced by the widest one, so ticks
+ * reuse one entry and resizes or autohide reveals measure nothing again */
+static void
+axisclock_update_layout(AxisClockPlugin *axisclock)
+{
+    AxisClockLayout *layout;
+    gchar *shape;
+    gchar *key;
+    
+    if (axisclock->layout_font == NULL)
+        axisclock_measure_font(axisclock);
+    
+    shape = g_strdup(axisclock->last_text != NULL ? axisclock->last_text : "");
+    for (gchar *p = shape; *p != '\0'; p++) {
+        if (g_ascii_isdigit(*p))
+            *p = axisclock->widest_digit;
+    }
+    
+    key = g_strdup_printf("%d:%d:%s:%s", axisclock->mode, axisclock->panel_size, axisclock->layout_font, shape);
+    if (g_strcmp0(key, axisclock->layout_key) == 0) {
+        g_free(key);
+        g_free(shape);
+        return;
+    }
+    
+    layout = g_hash_table_lookup(axisclock->layouts, key);
+    if (layout == NULL) {
+        if (g_hash_table_size(axisclock->layouts) >= LAYOUT_CACHE_SIZE)
+            g_hash_table_remove_all(axisclock->layouts);
+        layout = axisclock_measure_layout(axisclock, shape);
+        g_hash_table_insert(axisclock->layouts, g_strdup(key), layout);
+    }
+    
+    gtk_widget_set_size_request(axisclock->label, layout->width, layout->height);
+    
+    g_free(axisclock->layout_key);
+    axisclock->layout_key = key;
+    g_free(shape);
+}
+
+/* Label font, theme, screen or scale changed: measure everything again.
+ * A DPI or hinting change keeps the font name, so the cached sizes are
+ * dropped rather than left keyed by it */
+static void
+axisclock_rebuild_layout(gpointer data)
+{
+    AxisClockPlugin *axisclock = (AxisClockPlugin *)data;
+    
+    g_hash_table_remove_all(axisclock->layouts);
+    g_clear_pointer(&axisclock->layout_font, g_free);
+    g_clear_pointer(&axisclock->layout_key, g_free);
+    axisclock_update_layout(axisclock);
+}
+
+/* Configure the label for the panel mode: one line, stacked or rotated */
+static void
+axisclock_apply_mode(AxisClockPlugin *axisclock)
+{
+    GtkLabel *label = GTK_LABEL(axisclock->label);
+    gboolean vertical = axisclock->mode == XFCE_PANEL_PLUGIN_MODE_VERTICAL;
+    gboolean deskbar = axisclock->mode == XFCE_PANEL_PLUGIN_MODE_DESKBAR;
+    
+    gtk_label_set_angle(label, vertical ? 270.0 : 0.0);
+    gtk_label_set_line_wrap(label, deskbar);
+    gtk_label_set_line_wrap_mode(label, PANGO_WRAP_WORD);
+    gtk_label_set_justify(label, deskbar ? GTK_JUSTIFY_CENTER : GTK_JUSTIFY_LEFT);
+    
+    /* Padding goes along the text */
+    gtk_widget_set_margin_start(axisclock->label, vertical ? 0 : LABEL_MARGIN);
+    gtk_widget_set_margin_end(axisclock->label, vertical ? 0 : LABEL_MARGIN);
+    gtk_widget_set_margin_top(axisclock->label, vertical ? LABEL_MARGIN : 0);
+    gtk_widget_set_margin_bottom(axisclock->label, vertical ? LABEL_MARGIN : 0);
+}
+
+/* Render every additional zone from the shared tick */
+static gchar *
+axisclock_format_zones(AxisClockPlugin *axisclock, const AxisClockTick *tick)
+{
+    const gchar *separator;
+    GString *text;
+    
+    if (axisclock->zones->len == 0)
+        return NULL;
+    
+    separator = axisclock->config->zone_display == PLUGIN_ZONE_DISPLAY_LABEL ? "  " : "\n";
+    text = g_string_new(NULL);
+    
+    for (guint i = 0; i < axisclock->zones->len; i++) {
+        AxisClockZone *zone = g_ptr_array_index(axisclock->zones, i);
+        
+        g_string_append_printf(text, "%s%s %s", i > 0 ? separator : "", zone->display_name,
+                               axisclock_tick_format(tick, zone, axisclock->minute_zone_format
+                                                                 ? axisclock->minute_zone_format
+                                                                 : axisclock->config->zone_format));
+    }
+    
+    return g_string_free(text, FALSE);
+}
+
+/* Long date, ISO week, zone and UTC offset for @now; @valid_until receives
+ * the next local midnight */
+static gchar *
+axisclock_build_tooltip(gint64 now, gint64 *valid_until, glong *gmtoff)
+{
+    time_t t = (time_t)now;
+    struct tm tm;
+    struct tm midnight;
+    gchar date[128];
+    const gchar *zone_name = NULL;
+    GTimeZone *tz;
+    gchar *text;
+    glong offset;
+    gint week;
+    
+    localtime_r(&t, &tm);
+    
+    if (strftime(date, sizeof(date), "%A, %-d %B %Y", &tm) == 0)
+        date[0] = '\0';
+    week = axisclock_date_iso_week(axisclock_date_to_days(tm.tm_year + 1900, tm.tm_mon + 1, tm.tm_mday));
+    
+    tz = g_time_zone_new_local();
+#if GLIB_CHECK_VERSION(2, 58, 0)
+    zone_name = g_time_zone_get_identifier(tz);
+#endif
+    if (zone_name == NULL || *zone_name == '\0' || g_strcmp0(zone_name, ":/etc/localtime") == 0)
+        zone_name = tm.tm_zone;
+    
+    offset = ABS(tm.tm_gmtoff);
+    text = g_strdup_printf("%s\nWeek %d\n%s, UTC%c%02ld:%02ld (%s)", date, week, zone_name,
+                           tm.tm_gmtoff < 0 ? '-' : '+', offset / 3600, (offset / 60) % 60, tm.tm_zone);
+    g_time_zone_unref(tz);
+    
+    midnight = tm;
+    midnight.tm_mday++;
+    midnight.tm_hour = midnight.tm_min = midnight.tm_sec = 0;
+    midnight.tm_isdst = -1;
+    *valid_until = (gint64)mktime(&midnight);
+    *gmtoff = tm.tm_gmtoff;
+    
+    return text;
+}
+
+/* Tooltip on hover; nothing is formatted unless the pointer is over the
+ * clock and the cached text has expired */
+static gboolean
+axisclock_query_tooltip(GtkWidget *widget G_GNUC_UNUSED, gint x G_GNUC_UNUSED, gint y G_GNUC_UNUSED,
+                        gboolean keyboard_mode G_GNUC_UNUSED, GtkTooltip *tooltip, gpointer data)
+{
+    AxisClockPlugin *axisclock = (AxisClockPlugin *)data;
+    gint64 now = g_get_real_time() / G_USEC_PER_SEC;
+    
+    if (axisclock->tooltip_text == NULL || now >= axisclock->tooltip_valid_until) {
+        g_free(axisclock->tooltip_text);
+        axisclock->tooltip_text = axisclock_build_tooltip(now, &axisclock->tooltip_valid_until,
+                                                          &axisclock->tooltip_gmtoff);
+    }
+    
+    /* Zones shown in the tooltip are already rendered by the tick */
+    if (axisclock->config->zone_display == PLUGIN_ZONE_DISPLAY_TOOLTIP && axisclock->last_zones_text != NULL) {
+        gchar *text = g_strconcat(axisclock->tooltip_text, "\n\n", axisclock->last_zones_text, NULL);
+        
+        gtk_tooltip_set_text(tooltip, text);
+        g_free(text);
+    } else {
+        gtk_tooltip_set_text(tooltip, axisclock->tooltip_text);
+    }
+    
+    return TRUE;
+}
+
+/* Seconds between visible changes for the current configuration, made
+ * coarser by the battery policy when @on_battery */
+static guint
+axisclock_get_granularity(AxisClockPlugin *axisclock, gboolean on_battery)
+{
+    PluginBatteryPolicy policy = on_battery ? axisclock->config->battery_policy : PLUGIN_BATTERY_POLICY_NONE;
+    const gchar *format = axisclock->config->time_format ? axisclock->config->time_format
+                                                         : AXISCLOCK_TIME_FORMAT;
+    guint granularity;
+    
+    /* Fuzzy text changes once per slot, e.g. 288 times a day */
+    if (axisclock->config->display_mode == PLUGIN_DISPLAY_MODE_FUZZY)
+        granularity = axisclock->config->fuzzy_minutes * 60;
+    else
+        granularity = axisclock_format_get_granularity(format);
+    
+    if (axisclock->zones->len > 0)
+        granularity = MIN(granularity, axisclock_format_get_granularity(axisclock->config->zone_format));
+    
+    /* On battery the clock moves to minute boundaries and is rendered
+     * without its seconds field, see axisclock_update_time() */
+    if (policy != PLUGIN_BATTERY_POLICY_NONE)
+        granularity = MAX(granularity, 60);
+    
+    /* Per-second updates only while a countdown or stopwatch is running */
+    if (axisclock_alarms_is_running(axisclock->alarms) && policy != PLUGIN_BATTERY_POLICY_MINUTES)
+        granularity = 1;
+    
+    return granularity;
+}
+
+/* Render the shared tick into this instance's widgets */
+static void
+axisclock_render_tick(AxisClockPlugin *axisclock, const AxisClockTick *tick)
+{
+    const gchar *format = axisclock->config->time_format ? axisclock->config->time_format : AXISCLOCK_TIME_FORMAT;
+    gchar *time_string;
+    gchar *zones_string;
+    gchar *alarms_string;
+    
+    AXISCLOCK_PROBE_BEGIN(probe_start);
+    
+    if (axisclock->minute_time_format != NULL)
+        format = axisclock->minute_time_format;
+    
+    axisclock->last_tick = *tick;
+    
+    /* A DST switch or zone change moves the offset shown in the tooltip */
+    if (axisclock->tooltip_text != NULL && tick->local_time.tm_gmtoff != axisclock->tooltip_gmtoff)
+        g_clear_pointer(&axisclock->tooltip_text, g_free);
+    
+    if (axisclock->config->display_mode == PLUGIN_DISPLAY_MODE_FUZZY)
+        time_string = g_strdup(axisclock_format_fuzzy(&tick->local_time, axisclock->config->fuzzy_minutes));
+    else
+        time_string = g_strdup(axisclock_tick_format(tick, NULL, format));
+    zones_string = axisclock_format_zones(axisclock, tick);
+    
+    if (zones_string != NULL && axisclock->config->zone_display == PLUGIN_ZONE_DISPLAY_LABEL) {
+        gchar *combined = g_strconcat(time_string, "  ", zones_string, NULL);
+        
+        g_free(time_string);
+        time_string = combined;
+    } else if (g_strcmp0(zones_string, axisclock->last_zones_text) != 0) {
+        /* Tooltip and popup only change when the zones text does */
+        if (axisclock->config->zone_display == PLUGIN_ZONE_DISPLAY_TOOLTIP)
+            gtk_widget_trigger_tooltip_query(axisclock->ebox);
+        else
+            axisclock_calendar_set_zones_text(axisclock->calendar, zones_string);
+    }
+    
+    g_free(axisclock->last_zones_text);
+    axisclock->last_zones_text = zones_string;
+    
+    alarms_string = axisclock_alarms_format(axisclock->alarms);
+    if (alarms_string != NULL) {
+        gchar *combined = g_strconcat(time_string, "  ", alarms_string, NULL);
+        
+        g_free(time_string);
+        g_free(alarms_string);
+        time_string = combined;
+    }
+    
+    /* Only touch the label when the text actually changed */
+    if (g_strcmp0(time_string, axisclock->last_text) == 0) {
+        AXISCLOCK_COUNT(AXISCLOCK_COUNTER_LABEL_SKIPPED);
+        g_free(time_string);
+    } else {
+        AXISCLOCK_COUNT(AXISCLOCK_COUNTER_LABEL_UPDATES);
+        g_free(axisclock->last_text);
+        axisclock->last_text = time_string;
+        
+        if (axisclock->use_glyphs) {
+            axisclock_glyph_renderer_set_text(axisclock->glyphs, time_string);
+        } else {
+            gtk_label_set_text(GTK_LABEL(axisclock->label), time_string);
+            axisclock_update_layout(axisclock);
+        }
+        
+        if (axisclock->dbus_service != NULL)
+            axisclock_dbus_service_emit_changed(axisclock->dbus_service, time_string);
+    }
+    
+    AXISCLOCK_PROBE_END(AXISCLOCK_PROBE_UPDATE_TIME, probe_start);
+}
+
+/* Shared tick callback */
+static void
+axisclock_tick_cb(const AxisClockTick *tick, gpointer data)
+{
+    AxisClockPlugin *axisclock = (AxisClockPlugin *)data;
+    
+    /* Each tick stands in for this many ticks of the unrestricted rate */
+    AXISCLOCK_COUNT_N(AXISCLOCK_COUNTER_WAKEUPS_SAVED,
+                      axisclock->granularity / axisclock->requested_granularity - 1);
+    
+    axisclock_render_tick(axisclock, tick);
+}
+
+/* Switch between the label and the glyph atlas renderer */
+static void
+axisclock_set_use_glyphs(AxisClockPlugin *axisclock, gboolean use_glyphs)
+{
+    if (axisclock->use_glyphs == use_glyphs)
+        return;
+    
+    axisclock->use_glyphs = use_glyphs;
+    gtk_widget_set_visible(axisclock->label, !use_glyphs);
+    gtk_widget_set_visible(axisclock_glyph_renderer_get_widget(axisclock->glyphs), use_glyphs);
+    
+    /* Make the next render fill the newly shown widget */
+    g_clear_pointer(&axisclock->last_text, g_free);
+}
+
+/* Update the time display, e.g. after a configuration change */
 void
 axisclock_update_time(AxisClockPlugin *axisclock)
 {
-    gchar *time_string;
+    gboolean on_battery;
+    guint requested;
+    guint granularity;
     
     g_return_if_fail(axisclock != NULL);
     
-    /* Get formatted time */
-    time_string = axisclock_get_formatted_time(axisclock->config);
+    /* A format change or the power source may need a different update rate */
+    on_battery = axisclock_power_monitor_on_battery();
+    requested = axisclock_get_granularity(axisclock, FALSE);
+    granularity = axisclock_get_granularity(axisclock, on_battery);
+    if (granularity != requested && granularity != axisclock->granularity)
+        g_debug("On battery: %u wakeups per hour instead of %u", 3600 / granularity, 3600 / requested);
+    axisclock->requested_granularity = requested;
+    axisclock->granularity = granularity;
+    axisclock_tick_service_set_granularity(axisclock->subscription, granularity);
     
-    /* Update label */
-    gtk_label_set_text(GTK_LABEL(axisclock->label), time_string);
+    /* At minute updates a seconds field would sit at :00, so drop it */
+    g_clear_pointer(&axisclock->minute_time_format, g_free);
+    g_clear_pointer(&axisclock->minute_zone_format, g_free);
+    if (on_battery && axisclock->config->battery_policy != PLUGIN_BATTERY_POLICY_NONE) {
+        axisclock->minute_time_format = axisclock_format_without_seconds(axisclock->config->time_format
+                                                                         ? axisclock->config->time_format
+                                                                         : AXISCLOCK_TIME_FORMAT);
+        if (axisclock->config->zone_format != NULL)
+            axisclock->minute_zone_format = axisclock_format_without_seconds(axisclock->config->zone_format);
+    }
     
-    /* Free the string */
-    g_free(time_string);
+    /* Per-second text on a horizontal panel is blitted from the atlas
+     * instead of laid out */
+    axisclock_set_use_glyphs(axisclock, granularity == 1 && axisclock->mode == XFCE_PANEL_PLUGIN_MODE_HORIZONTAL);
+    
+    axisclock_render_tick(axisclock, axisclock_tick_service_get_tick());
 }
 
-/* Timeout callback for updating time */
-static gboolean
-axisclock_update_timeout(gpointer data)
+/* Re-reference the shared zone tables after the zone list or display mode
+ * changed */
+void
+axisclock_reload_zones(AxisClockPlugin *axisclock)
 {
-    AxisClockPlugin *axisclock = (AxisClockPlugin *)data;
+    g_return_if_fail(axisclock != NULL);
+    
+    g_ptr_array_set_size(axisclock->zones, 0);
+    
+    for (gchar **id = axisclock->config->zones; id != NULL && *id != NULL; id++) {
+        AxisClockZone *zone = axisclock_tick_service_ref_zone(*id);
+        
+        if (zone != NULL)
+            g_ptr_array_add(axisclock->zones, zone);
+        else
+            g_warning("Unknown time zone '%s'", *id);
+    }
+    
+    /* Clear whatever the previous display mode showed */
+    axisclock_calendar_set_zones_text(axisclock->calendar, NULL);
+    g_clear_pointer(&axisclock->last_zones_text, g_free);
     
     axisclock_update_time(axisclock);
+}
+
+/* Countdown or stopwatch started, stopped or finished */
+static void
+axisclock_alarms_changed_cb(AxisClockAlarms *alarms G_GNUC_UNUSED, gpointer data)
+{
+    axisclock_update_time((AxisClockPlugin *)data);
+}
+
+/* Panel orientation changed */
+void
+axisclock_set_mode(AxisClockPlugin *axisclock, XfcePanelPluginMode mode)
+{
+    g_return_if_fail(axisclock != NULL);
     
-    /* Continue timeout */
-    return TRUE;
+    if (axisclock->mode == mode)
+        return;
+    
+    axisclock->mode = mode;
+    axisclock_apply_mode(axisclock);
+    axisclock_update_time(axisclock);
+    axisclock_update_layout(axisclock);
+}
+
+/* Panel thickness changed */
+void
+axisclock_set_size(AxisClockPlugin *axisclock, gint size)
+{
+    g_return_if_fail(axisclock != NULL);
+    
+    if (axisclock->panel_size == size)
+        return;
+    
+    axisclock->panel_size = size;
+    axisclock_update_layout(axisclock);
+}
+
+/* Switched between battery and AC */
+static void
+axisclock_power_changed_cb(gboolean on_battery G_GNUC_UNUSED, gpointer data)
+{
+    axisclock_update_time((AxisClockPlugin *)data);
 }
 
 /* Click handler for showing calendar */
@@ -86,11 +539,16 @@ AxisClockPlugin *
 axisclock_create_plugin(XfcePanelPlugin *plugin)
 {
     AxisClockPlugin *axisclock;
+    GtkWidget *box;
+    GtkWidget *glyphs_widget;
     
     /* Allocate plugin structure */
     axisclock = g_new0(AxisClockPlugin, 1);
     axisclock->plugin = plugin;
     
+    /* Hook up the SIGUSR1 counter dump (profiling builds only) */
+    axisclock_profiler_init();
+    
     /* Initialize configuration */
     axisclock->config = plugin_config_new();
     
@@ -105,16 +563,32 @@ axisclock_create_plugin(XfcePanelPlugin *plugin)
     axisclock->ebox = gtk_event_box_new();
     gtk_widget_show(axisclock->ebox);
     
+    /* Box holding whichever of the label and the glyph renderer is active */
+    box = gtk_box_new(GTK_ORIENTATION_HORIZONTAL, 0);
+    gtk_widget_show(box);
+    gtk_container_add(GTK_CONTAINER(axisclock->ebox), box);
+    
     /* Create label for time display */
     axisclock->label = gtk_label_new("");
+    gtk_widget_set_no_show_all(axisclock->label, TRUE);
     gtk_widget_show(axisclock->label);
     
-    /* Add padding around the label */
-    gtk_widget_set_margin_start(axisclock->label, 4);
-    gtk_widget_set_margin_end(axisclock->label, 4);
+    /* Lay the label out for the panel's mode; padding is set there too */
+    axisclock->mode = xfce_panel_plugin_get_mode(plugin);
+    axisclock->panel_size = xfce_panel_plugin_get_size(plugin);
+    axisclock->layouts = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, g_free);
+    axisclock_apply_mode(axisclock);
+    
+    /* Add label to the box */
+    gtk_box_pack_start(GTK_BOX(box), axisclock->label, TRUE, TRUE, 0);
     
-    /* Add label to event box */
-    gtk_container_add(GTK_CONTAINER(axisclock->ebox), axisclock->label);
+    /* Glyph atlas renderer, shown while the clock updates every second */
+    axisclock->glyphs = axisclock_glyph_renderer_new();
+    glyphs_widget = axisclock_glyph_renderer_get_widget(axisclock->glyphs);
+    gtk_widget_set_no_show_all(glyphs_widget, TRUE);
+    gtk_widget_set_margin_start(glyphs_widget, LABEL_MARGIN);
+    gtk_widget_set_margin_end(glyphs_widget, LABEL_MARGIN);
+    gtk_box_pack_start(GTK_BOX(box), glyphs_widget, TRUE, TRUE, 0);
     
     /* Add event box to plugin */
     gtk_container_add(GTK_CONTAINER(plugin), axisclock->ebox);
@@ -125,17 +599,57 @@ axisclock_create_plugin(XfcePanelPlugin *plugin)
     /* Apply transparency from configuration */
     axisclock_calendar_set_transparency(axisclock->calendar, axisclock->config->calendar_transparency);
     
+    /* Week numbers and public holidays */
+    axisclock_calendar_set_week_numbers(axisclock->calendar, axisclock->config->show_week_numbers);
+    axisclock_calendar_set_holidays(axisclock->calendar, axisclock->config->holiday_country);
+    axisclock_calendar_set_secondary_calendar(axisclock->calendar, axisclock->config->secondary_calendar);
+    
+    /* Sun and moon annotations */
+    axisclock_calendar_set_location(axisclock->calendar, axisclock->config->show_astronomy,
+                                    axisclock->config->latitude, axisclock->config->longitude);
+    
+    /* Coalesce style, screen and scale notifications of every surface
+     * into one rebuild per frame */
+    axisclock->invalidator = axisclock_invalidator_new();
+    axisclock_invalidator_watch(axisclock->invalidator, axisclock->label);
+    axisclock_invalidator_watch(axisclock->invalidator, glyphs_widget);
+    axisclock_invalidator_watch(axisclock->invalidator, axisclock->calendar->window);
+    axisclock_invalidator_add_client(axisclock->invalidator, axisclock_rebuild_layout, axisclock);
+    axisclock_invalidator_add_client(axisclock->invalidator,
+                                     (AxisClockRebuildFunc)axisclock_glyph_renderer_invalidate, axisclock->glyphs);
+    axisclock_invalidator_add_client(axisclock->invalidator,
+                                     (AxisClockRebuildFunc)axisclock_calendar_reload_style, axisclock->calendar);
+    
+    /* Mark days that have events in the configured .ics files */
+    axisclock_calendar_set_event_sources(axisclock->calendar,
+                                         (const gchar * const *)axisclock->config->ics_files);
+    
+    /* Date tooltip, formatted only when hovered */
+    gtk_widget_set_has_tooltip(axisclock->ebox, TRUE);
+    g_signal_connect(G_OBJECT(axisclock->ebox), "query-tooltip",
+                     G_CALLBACK(axisclock_query_tooltip), axisclock);
+    
     /* Connect click signal */
     g_signal_connect(G_OBJECT(axisclock->ebox), "button-press-event",
                      G_CALLBACK(axisclock_button_clicked), axisclock);
     
-    /* Initial time update */
-    axisclock_update_time(axisclock);
+    /* Subscribe to the process-wide tick; the granularity is corrected by
+     * the initial update below */
+    axisclock->subscription = axisclock_tick_service_subscribe(60, axisclock_tick_cb, axisclock);
+    
+    /* Alarms sit in the deadline queue and cost nothing until due */
+    axisclock->alarms = axisclock_alarms_new(axisclock_alarms_changed_cb, axisclock);
+    axisclock_alarms_set_schedule(axisclock->alarms, (const gchar * const *)axisclock->config->alarms);
+    
+    /* Follow the power source for the battery policy */
+    axisclock->power_watch = axisclock_power_monitor_watch(axisclock_power_changed_cb, axisclock);
     
-    /* Setup timeout for updates */
-    axisclock->timeout_id = g_timeout_add(AXISCLOCK_UPDATE_INTERVAL,
-                                         axisclock_update_timeout,
-                                         axisclock);
+    /* Answer D-Bus queries from the rendered state */
+    axisclock->dbus_service = axisclock_dbus_service_new(axisclock, xfce_panel_plugin_get_unique_id(plugin));
+    
+    /* Reference the shared zone tables; this also does the initial update */
+    axisclock->zones = g_ptr_array_new_with_free_func((GDestroyNotify)axisclock_tick_service_unref_zone);
+    axisclock_reload_zones(axisclock);
     
     return axisclock;
 }
@@ -146,12 +660,24 @@ axisclock_destroy_plugin(AxisClockPlugin *axisclock)
 {
     g_return_if_fail(axisclock != NULL);
     
-    /* Remove timeout */
-    if (axisclock->timeout_id != 0) {
-        g_source_remove(axisclock->timeout_id);
-        axisclock->timeout_id = 0;
+    /* Stop receiving ticks */
+    if (axisclock->subscription != NULL) {
+        axisclock_tick_service_unsubscribe(axisclock->subscription);
+        axisclock->subscription = NULL;
     }
     
+    /* Stop following the power source */
+    g_clear_pointer(&axisclock->power_watch, axisclock_power_monitor_unwatch);
+    
+    /* Leave the bus */
+    g_clear_pointer(&axisclock->dbus_service, axisclock_dbus_service_free);
+    
+    /* Stop following style changes before the widgets go away */
+    g_clear_pointer(&axisclock->invalidator, axisclock_invalidator_free);
+    
+    /* Cancel pending alarms and the countdown */
+    g_clear_pointer(&axisclock->alarms, axisclock_alarms_free);
+    
     /* Destroy calendar popup */
     if (axisclock->calendar != NULL) {
         axisclock_calendar_destroy(axisclock->calendar);
@@ -170,6 +696,18 @@ axisclock_destroy_plugin(AxisClockPlugin *axisclock)
         axisclock->channel = NULL;
     }
     
+    g_clear_pointer(&axisclock->glyphs, axisclock_glyph_renderer_free);
+    g_hash_table_destroy(axisclock->layouts);
+    g_free(axisclock->layout_key);
+    g_free(axisclock->layout_font);
+    g_free(axisclock->last_text);
+    g_free(axisclock->last_zones_text);
+    g_free(axisclock->tooltip_text);
+    g_free(axisclock->minute_time_format);
+    g_free(axisclock->minute_zone_format);
+    g_ptr_array_free(axisclock->zones, TRUE);
+    axisclock_profiler_shutdown();
+    
     /* Free plugin structure */
     g_free(axisclock);
 }
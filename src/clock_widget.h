@@ -27,14 +27,17 @@
 #include <gtk/gtk.h>
 #include <libxfce4panel/libxfce4panel.h>
 #include <xfconf/xfconf.h>
+#include "alarms.h"
 #include "calendar_popup.h"
+#include "dbus_service.h"
+#include "glyph_renderer.h"
+#include "invalidator.h"
 #include "plugin_config.h"
+#include "power_monitor.h"
+#include "tick_service.h"
 
 G_BEGIN_DECLS
 
-/* Update interval in milliseconds (1 second) */
-#define AXISCLOCK_UPDATE_INTERVAL 1000
-
 typedef struct _AxisClockPlugin AxisClockPlugin;
 
 /* Plugin structure */
@@ -45,21 +48,74 @@ struct _AxisClockPlugin {
     GtkWidget *ebox;
     GtkWidget *label;
     
+    /* Atlas renderer shown instead of the label while updating every
+     * second */
+    AxisClockGlyphRenderer *glyphs;
+    gboolean use_glyphs;
+    
+    /* Panel mode and size, and the label size requests measured for each
+     * (mode, size, font, text shape) seen so far */
+    XfcePanelPluginMode mode;
+    gint panel_size;
+    GHashTable *layouts;
+    gchar *layout_key;
+    gchar *layout_font;
+    gchar widest_digit;
+    
+    /* Last text pushed to the label, to skip no-op updates */
+    gchar *last_text;
+    
+    /* Tick the label was last rendered from, served over D-Bus */
+    AxisClockTick last_tick;
+    
+    /* Date tooltip, built on first hover and kept until the next local
+     * midnight or a UTC offset change */
+    gchar *tooltip_text;
+    gint64 tooltip_valid_until;
+    glong tooltip_gmtoff;
+    
+    /* Additional time zones (AxisClockZone *) and their last rendering */
+    GPtrArray *zones;
+    gchar *last_zones_text;
+    
     /* Calendar popup */
     AxisClockCalendar *calendar;
     
+    /* Rebuilds the label, atlas and popup style caches once per burst of
+     * style, screen and scale changes */
+    AxisClockInvalidator *invalidator;
+    
     /* Configuration */
     PluginConfig *config;
     XfconfChannel *channel;
     
-    /* Update timeout */
-    guint timeout_id;
+    /* Subscription to the process-wide tick */
+    AxisClockTickSubscription *subscription;
+    
+    /* Alarms, countdown and stopwatch */
+    AxisClockAlarms *alarms;
+    
+    /* Battery policy: tick granularity in use and the one it replaced */
+    AxisClockPowerWatch *power_watch;
+    guint granularity;
+    guint requested_granularity;
+    
+    /* Clock and zone formats without seconds while the policy drops them,
+     * NULL to render the configured ones */
+    gchar *minute_time_format;
+    gchar *minute_zone_format;
+    
+    /* Session-bus query interface */
+    AxisClockDBusService *dbus_service;
 };
 
 /* Function prototypes */
 AxisClockPlugin *axisclock_create_plugin(XfcePanelPlugin *plugin);
 void axisclock_destroy_plugin(AxisClockPlugin *axisclock);
 void axisclock_update_time(AxisClockPlugin *axisclock);
+void axisclock_reload_zones(AxisClockPlugin *axisclock);
+void axisclock_set_mode(AxisClockPlugin *axisclock, XfcePanelPluginMode mode);
+void axisclock_set_size(AxisClockPlugin *axisclock, gint size);
 
 G_END_DECLS
 
@@ -0,0 +1,411 @@
+/*
+ * xfce4-axisclock-plugin - A macOS-style clock plugin for the Xfce panel
+ *
+ * Copyright (c) 2025 Kamil 'Novik' Nowicki <novik@axisos.org>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Website: https://axisos.org
+ * Repository: https://github.com/AxisOS/xfce4-axisclock-plugin
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <glib.h>
+#include <glib/gstdio.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/file.h>
+
+#include "data_cache.h"
+#include "profiler.h"
+
+#define DATA_CACHE_FILE "axisclock-data.cache"
+#define DATA_CACHE_LOCK_FILE DATA_CACHE_FILE ".lock"
+#define DATA_CACHE_MAGIC "AXCLKDC"
+#define DATA_CACHE_BYTE_ORDER 0x01020304
+
+/* Entries kept; the oldest are dropped past this */
+#define DATA_CACHE_MAX_ENTRIES 128
+
+/* Payload alignment, enough for the gint64 fields of any entry */
+#define DATA_CACHE_ALIGN 8
+#define DATA_CACHE_ALIGN_UP(offset) (((offset) + DATA_CACHE_ALIGN - 1) & ~(gsize)(DATA_CACHE_ALIGN - 1))
+
+typedef struct {
+    gchar   magic[8];
+    guint32 version;
+    guint32 byte_order;             /* Written natively, so a foreign file never matches */
+    guint32 n_entries;
+    guint32 reserved;
+} CacheHeader;
+
+typedef struct {
+    guint64 stamp;
+    guint32 name;                   /* Offset of the NUL-terminated name */
+    guint32 data;                   /* Offset of the payload */
+    guint32 size;
+    guint32 checksum;               /* FNV-1a of the payload */
+} CacheEntry;
+
+/* An entry being written: kept from the old file or new */
+typedef struct {
+    const gchar  *name;
+    guint64       stamp;
+    gconstpointer data;
+    gsize         size;
+    guint32       checksum;
+} PendingEntry;
+
+/* Payload check state of an entry of the current mapping */
+enum {
+    DATA_CACHE_UNCHECKED,
+    DATA_CACHE_INTACT,
+    DATA_CACHE_CORRUPT
+};
+
+/* Current mapping and the file it was made from */
+static gchar *cache_path = NULL;
+static GBytes *cache_bytes = NULL;
+static guint8 *cache_checked = NULL;    /* Per entry, checked on first lookup */
+static guint64 cache_inode;
+static gint64 cache_size;
+static gint64 cache_mtime;
+
+static const gchar *
+data_cache_path(void)
+{
+    if (cache_path == NULL)
+        cache_path = g_build_filename(g_get_user_runtime_dir(), DATA_CACHE_FILE, NULL);
+    return cache_path;
+}
+
+static guint32
+data_cache_checksum(const guint8 *data, gsize size)
+{
+    guint32 hash = 2166136261u;
+    
+    for (gsize i = 0; i < size; i++) {
+        hash ^= data[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+/* Map the file again if it was replaced since, NULL if it is missing or
+ * not a cache of this version */
+static GBytes *
+data_cache_map(void)
+{
+    const CacheHeader *header;
+    GMappedFile *file;
+    GBytes *bytes;
+    GStatBuf st;
+    gsize size;
+    
+    if (g_stat(data_cache_path(), &st) != 0) {
+        g_clear_pointer(&cache_bytes, g_bytes_unref);
+        g_clear_pointer(&cache_checked, g_free);
+        return NULL;
+    }
+    
+    if (cache_bytes != NULL && (guint64)st.st_ino == cache_inode &&
+        (gint64)st.st_size == cache_size && (gint64)st.st_mtime == cache_mtime)
+        return cache_bytes;
+    
+    /* Data handed out earlier keeps the old mapping alive */
+    g_clear_pointer(&cache_bytes, g_bytes_unref);
+    g_clear_pointer(&cache_checked, g_free);
+    cache_inode = st.st_ino;
+    cache_size = st.st_size;
+    cache_mtime = st.st_mtime;
+    
+    file = g_mapped_file_new(data_cache_path(), FALSE, NULL);
+    if (file == NULL)
+        return NULL;
+    bytes = g_mapped_file_get_bytes(file);
+    g_mapped_file_unref(file);
+    
+    header = g_bytes_get_data(bytes, &size);
+    if (size < sizeof(CacheHeader) ||
+        memcmp(header->magic, DATA_CACHE_MAGIC, sizeof(header->magic)) != 0 ||
+        header->version != AXISCLOCK_DATA_CACHE_VERSION ||
+        header->byte_order != DATA_CACHE_BYTE_ORDER ||
+        header->n_entries > (size - sizeof(CacheHeader)) / sizeof(CacheEntry)) {
+        g_bytes_unref(bytes);
+        return NULL;
+    }
+    
+    cache_bytes = bytes;
+    cache_checked = g_malloc0(MAX(header->n_entries, 1));
+    return cache_bytes;
+}
+
+/* Whether the payload of entry @i of the current mapping matches its
+ * checksum. Verified once per mapping, so repeated lookups do not touch
+ * the payload pages again */
+static gboolean
+data_cache_entry_intact(const CacheEntry *entry, guint i)
+{
+    const guint8 *data = g_bytes_get_data(cache_bytes, NULL);
+    
+    if (cache_checked[i] == DATA_CACHE_UNCHECKED)
+        cache_checked[i] = data_cache_checksum(data + entry->data, entry->size) == entry->checksum
+                           ? DATA_CACHE_INTACT : DATA_CACHE_CORRUPT;
+    
+    return cache_checked[i] == DATA_CACHE_INTACT;
+}
+
+/* Serialize writers across processes, -1 if the lock file is unusable.
+ * Closing the descriptor releases the lock */
+static gint
+data_cache_lock(void)
+{
+    gchar *path = g_build_filename(g_get_user_runtime_dir(), DATA_CACHE_LOCK_FILE, NULL);
+    gint fd = g_open(path, O_RDWR | O_CREAT | O_CLOEXEC, 0600);
+    
+    while (fd >= 0 && flock(fd, LOCK_EX) != 0) {
+        if (errno != EINTR) {
+            g_debug("Cannot lock %s: %s", path, g_strerror(errno));
+            close(fd);
+            fd = -1;
+        }
+    }
+    
+    g_free(path);
+    return fd;
+}
+
+/* Entry @i of @bytes and its name, NULL if it points outside the file */
+static const CacheEntry *
+data_cache_get_entry(GBytes *bytes, guint i, const gchar **name)
+{
+    gsize size;
+    const guint8 *data = g_bytes_get_data(bytes, &size);
+    const CacheEntry *entry = (const CacheEntry *)(data + sizeof(CacheHeader)) + i;
+    
+    if (entry->name >= size || memchr(data + entry->name, '\0', size - entry->name) == NULL)
+        return NULL;
+    if (entry->data % DATA_CACHE_ALIGN != 0 || entry->data > size || entry->size > size - entry->data)
+        return NULL;
+    
+    *name = (const gchar *)data + entry->name;
+    return entry;
+}
+
+/**
+ * axisclock_data_cache_lookup:
+ * @name: Entry name, e.g. "zone/Europe/Paris"
+ * @stamp: Stamp of the sources the caller would build the entry from
+ *
+ * Returns: (transfer full): The payload, read-only and suitably aligned,
+ * or %NULL if there is no entry with this stamp and an intact payload.
+ */
+GBytes *
+axisclock_data_cache_lookup(const gchar *name, guint64 stamp)
+{
+    const guint8 *data;
+    GBytes *bytes;
+    guint n_entries;
+    
+    g_return_val_if_fail(name != NULL, NULL);
+    
+    bytes = data_cache_map();
+    if (bytes == NULL) {
+        AXISCLOCK_COUNT(AXISCLOCK_COUNTER_DATA_CACHE_MISSES);
+        return NULL;
+    }
+    
+    data = g_bytes_get_data(bytes, NULL);
+    n_entries = ((const CacheHeader *)data)->n_entries;
+    
+    for (guint i = 0; i < n_entries; i++) {
+        const gchar *entry_name;
+        const CacheEntry *entry = data_cache_get_entry(bytes, i, &entry_name);
+        
+        if (entry == NULL || strcmp(entry_name, name) != 0)
+            continue;
+        if (entry->stamp != stamp || !data_cache_entry_intact(entry, i))
+            break;
+        
+        AXISCLOCK_COUNT(AXISCLOCK_COUNTER_DATA_CACHE_HITS);
+        return g_bytes_new_from_bytes(bytes, entry->data, entry->size);
+    }
+    
+    AXISCLOCK_COUNT(AXISCLOCK_COUNTER_DATA_CACHE_MISSES);
+    return NULL;
+}
+
+/**
+ * axisclock_data_cache_store:
+ * @name: Entry name
+ * @stamp: Stamp of the sources @data was built from
+ * @data: Payload, without pointers
+ * @size: Size of @data
+ *
+ * Replaces the entry called @name, keeping the other entries of the
+ * current file, and atomically replaces the file. Writers hold a lock on
+ * a sidecar file from reading the current file to the rename, so
+ * instances starting together do not drop each other's entries. Failures
+ * only cost the next process a rebuild, so they are not reported.
+ */
+void
+axisclock_data_cache_store(const gchar *name, guint64 stamp, gconstpointer data, gsize size)
+{
+    GArray *pending;
+    PendingEntry added = { name, stamp, data, size, 0 };
+    GError *error = NULL;
+    CacheHeader *header;
+    guint8 *buffer;
+    gsize total;
+    gint lock_fd;
+    
+    g_return_if_fail(name != NULL);
+    g_return_if_fail(data != NULL || size == 0);
+    
+    pending = g_array_new(FALSE, FALSE, sizeof(PendingEntry));
+    added.checksum = data_cache_checksum(data, size);
+    
+    /* Keep the entries other processes stored since we last looked; the
+     * file is mapped again under the lock if one of them replaced it */
+    lock_fd = data_cache_lock();
+    if (data_cache_map() != NULL) {
+        const guint8 *old = g_bytes_get_data(cache_bytes, NULL);
+        guint n_entries = ((const CacheHeader *)old)->n_entries;
+        
+        for (guint i = 0; i < n_entries; i++) {
+            PendingEntry kept;
+            const CacheEntry *entry = data_cache_get_entry(cache_bytes, i, &kept.name);
+            
+            if (entry == NULL || strcmp(kept.name, name) == 0)
+                continue;
+            
+            /* Copied with their old checksum, so damage stays detectable */
+            kept.stamp = entry->stamp;
+            kept.data = old + entry->data;
+            kept.size = entry->size;
+            kept.checksum = entry->checksum;
+            g_array_append_val(pending, kept);
+        }
+    }
+    
+    g_array_append_val(pending, added);
+    if (pending->len > DATA_CACHE_MAX_ENTRIES)
+        g_array_remove_range(pending, 0, pending->len - DATA_CACHE_MAX_ENTRIES);
+    
+    /* Header and entry table, then the names, then the aligned payloads */
+    total = sizeof(CacheHeader) + pending->len * sizeof(CacheEntry);
+    for (guint i = 0; i < pending->len; i++)
+        total += strlen(g_array_index(pending, PendingEntry, i).name) + 1;
+    for (guint i = 0; i < pending->len; i++)
+        total = DATA_CACHE_ALIGN_UP(total) + g_array_index(pending, PendingEntry, i).size;
+    
+    if (total > G_MAXUINT32) {
+        if (lock_fd >= 0)
+            close(lock_fd);
+        g_array_free(pending, TRUE);
+        return;
+    }
+    
+    buffer = g_malloc0(total);
+    header = (CacheHeader *)buffer;
+    memcpy(header->magic, DATA_CACHE_MAGIC, sizeof(header->magic));
+    header->version = AXISCLOCK_DATA_CACHE_VERSION;
+    header->byte_order = DATA_CACHE_BYTE_ORDER;
+    header->n_entries = pending->len;
+    
+    total = sizeof(CacheHeader) + pending->len * sizeof(CacheEntry);
+    for (guint i = 0; i < pending->len; i++) {
+        const PendingEntry *source = &g_array_index(pending, PendingEntry, i);
+        CacheEntry *entry = (CacheEntry *)(header + 1) + i;
+        gsize length = strlen(source->name) + 1;
+        
+        entry->stamp = source->stamp;
+        entry->name = total;
+        memcpy(buffer + total, source->name, length);
+        total += length;
+    }
+    for (guint i = 0; i < pending->len; i++) {
+        const PendingEntry *source = &g_array_index(pending, PendingEntry, i);
+        CacheEntry *entry = (CacheEntry *)(header + 1) + i;
+        
+        total = DATA_CACHE_ALIGN_UP(total);
+        entry->data = total;
+        entry->size = source->size;
+        if (source->size > 0)
+            memcpy(buffer + total, source->data, source->size);
+        entry->checksum = source->checksum;
+        total += source->size;
+    }
+    
+    /* Written to a temporary file and renamed over the old one, so
+     * readers see either file whole */
+    if (!g_file_set_contents(data_cache_path(), (const gchar *)buffer, total, &error)) {
+        g_debug("Cannot write %s: %s", data_cache_path(), error->message);
+        g_error_free(error);
+    }
+    
+    if (lock_fd >= 0)
+        close(lock_fd);
+    g_free(buffer);
+    g_array_free(pending, TRUE);
+}
+
+/**
+ * axisclock_data_cache_stamp:
+ * @paths: (nullable): %NULL-terminated source files
+ * @extra: (nullable): Other inputs the entry depends on, e.g. a locale name
+ *
+ * Checksums the path, inode, size and modification time of each source
+ * file, so an updated tzdata or locale package changes the stamp without
+ * reading the files. Missing files count as well.
+ *
+ * Returns: The stamp to look up and store entries with.
+ */
+guint64
+axisclock_data_cache_stamp(const gchar *const *paths, const gchar *extra)
+{
+    GChecksum *checksum = g_checksum_new(G_CHECKSUM_SHA256);
+    guint8 digest[32];
+    gsize length = sizeof(digest);
+    guint64 stamp;
+    
+    for (guint i = 0; paths != NULL && paths[i] != NULL; i++) {
+        gint64 fields[3] = { -1, -1, -1 };
+        GStatBuf st;
+        
+        if (g_stat(paths[i], &st) == 0) {
+            fields[0] = st.st_ino;
+            fields[1] = st.st_size;
+            fields[2] = st.st_mtime;
+        }
+        
+        g_checksum_update(checksum, (const guchar *)paths[i], strlen(paths[i]) + 1);
+        g_checksum_update(checksum, (const guchar *)fields, sizeof(fields));
+    }
+    
+    if (extra != NULL)
+        g_checksum_update(checksum, (const guchar *)extra, -1);
+    
+    g_checksum_get_digest(checksum, digest, &length);
+    g_checksum_free(checksum);
+    
+    memcpy(&stamp, digest, sizeof(stamp));
+    return stamp;
+}
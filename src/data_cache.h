@@ -0,0 +1,56 @@
+/*
+ * xfce4-axisclock-plugin - A macOS-style clock plugin for the Xfce panel
+ *
+ * Copyright (c) 2025 Kamil 'Novik' Nowicki <novik@axisos.org>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Website: https://axisos.org
+ * Repository: https://github.com/AxisOS/xfce4-axisclock-plugin
+ */
+
+#ifndef __DATA_CACHE_H__
+#define __DATA_CACHE_H__
+
+#include <glib.h>
+
+G_BEGIN_DECLS
+
+/* Bumped whenever the file layout or any entry's payload layout changes */
+#define AXISCLOCK_DATA_CACHE_VERSION 1
+
+/*
+ * Immutable data shared by every AxisClock process of a session: zone
+ * transition tables, locale snapshots and the zone search index. They
+ * live as named entries in one file under $XDG_RUNTIME_DIR that is mapped
+ * read-only, so later instances and restarts share the pages instead of
+ * rebuilding private copies. Each entry carries a stamp, a checksum of
+ * the source files it was built from, and a checksum of its payload; an
+ * entry whose stamp or checksum does not match is rebuilt and stored
+ * again. The file is only ever replaced atomically, and payloads never
+ * contain pointers.
+ */
+GBytes  *axisclock_data_cache_lookup (const gchar        *name,
+                                      guint64             stamp);
+void     axisclock_data_cache_store  (const gchar        *name,
+                                      guint64             stamp,
+                                      gconstpointer       data,
+                                      gsize               size);
+guint64  axisclock_data_cache_stamp  (const gchar *const *paths,
+                                      const gchar        *extra);
+
+G_END_DECLS
+
+#endif /* !__DATA_CACHE_H__ */
@@ -0,0 +1,178 @@
+/*
+ * xfce4-axisclock-plugin - A macOS-style clock plugin for the Xfce panel
+ *
+ * Copyright (c) 2025 Kamil 'Novik' Nowicki <novik@axisos.org>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Website: https://axisos.org
+ * Repository: https://github.com/AxisOS/xfce4-axisclock-plugin
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <glib.h>
+
+#include "date_utils.h"
+
+/* Floor division for possibly negative day numbers */
+static inline gint32
+floor_div(gint32 a, gint32 b)
+{
+    return (a >= 0 ? a : a - b + 1) / b;
+}
+
+/**
+ * axisclock_date_to_days:
+ * @year: Year
+ * @month: Month, 1-12
+ * @day: Day of month, 1-31
+ *
+ * Returns: Days since 1970-01-01.
+ */
+gint32
+axisclock_date_to_days(gint year, gint month, gint day)
+{
+    gint32 era, yoe, doy, doe;
+    
+    /* Count from March so the leap day ends the year */
+    year -= month <= 2;
+    era = floor_div(year, 400);
+    yoe = year - era * 400;
+    doy = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+    doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    
+    return era * 146097 + doe - 719468;
+}
+
+/**
+ * axisclock_date_from_days:
+ * @days: Days since 1970-01-01
+ * @year: (out) (optional): Year
+ * @month: (out) (optional): Month, 1-12
+ * @day: (out) (optional): Day of month
+ *
+ * Inverse of axisclock_date_to_days().
+ */
+void
+axisclock_date_from_days(gint32 days, gint *year, gint *month, gint *day)
+{
+    gint32 z = days + 719468;
+    gint32 era = floor_div(z, 146097);
+    gint32 doe = z - era * 146097;
+    gint32 yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    gint32 doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    gint32 mp = (5 * doy + 2) / 153;
+    gint32 d = doy - (153 * mp + 2) / 5 + 1;
+    gint32 m = mp < 10 ? mp + 3 : mp - 9;
+    
+    if (year != NULL)
+        *year = yoe + era * 400 + (m <= 2);
+    if (month != NULL)
+        *month = m;
+    if (day != NULL)
+        *day = d;
+}
+
+/**
+ * axisclock_date_weekday:
+ * @days: Days since 1970-01-01
+ *
+ * Returns: Weekday, 0 = Sunday.
+ */
+gint
+axisclock_date_weekday(gint32 days)
+{
+    /* 1970-01-01 was a Thursday */
+    return (gint)(((days % 7) + 11) % 7);
+}
+
+/**
+ * axisclock_date_is_leap_year:
+ * @year: Year
+ *
+ * Returns: %TRUE if @year has a February 29.
+ */
+gboolean
+axisclock_date_is_leap_year(gint year)
+{
+    return (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+}
+
+/**
+ * axisclock_date_days_in_month:
+ * @year: Year
+ * @month: Month, 1-12
+ *
+ * Returns: Number of days in the month.
+ */
+gint
+axisclock_date_days_in_month(gint year, gint month)
+{
+    static const gint days[12] = { 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };
+    
+    if (month == 2 && axisclock_date_is_leap_year(year))
+        return 29;
+    
+    return days[(month - 1) % 12];
+}
+
+/**
+ * axisclock_date_iso_week:
+ * @days: Day number
+ *
+ * Returns: ISO 8601 week number, 1-53. Weeks start on Monday and week 1
+ *          holds the year's first Thursday.
+ */
+gint
+axisclock_date_iso_week(gint32 days)
+{
+    gint32 thursday = days - (axisclock_date_weekday(days) + 6) % 7 + 3;
+    gint year, month, day;
+    
+    axisclock_date_from_days(thursday, &year, &month, &day);
+    
+    return (thursday - axisclock_date_to_days(year, 1, 1)) / 7 + 1;
+}
+
+/**
+ * axisclock_date_easter:
+ * @year: Year
+ *
+ * Returns: Day number of Western (Gregorian) Easter Sunday.
+ */
+gint32
+axisclock_date_easter(gint year)
+{
+    /* Anonymous Gregorian algorithm */
+    gint a = year % 19;
+    gint b = year / 100;
+    gint c = year % 100;
+    gint d = b / 4;
+    gint e = b % 4;
+    gint f = (b + 8) / 25;
+    gint g = (b - f + 1) / 3;
+    gint h = (19 * a + b - d - g + 15) % 30;
+    gint i = c / 4;
+    gint k = c % 4;
+    gint l = (32 + 2 * e + 2 * i - h - k) % 7;
+    gint m = (a + 11 * h + 22 * l) / 451;
+    gint month = (h + l - 7 * m + 114) / 31;
+    gint day = (h + l - 7 * m + 114) % 31 + 1;
+    
+    return axisclock_date_to_days(year, month, day);
+}
@@ -0,0 +1,51 @@
+/*
+ * xfce4-axisclock-plugin - A macOS-style clock plugin for the Xfce panel
+ *
+ * Copyright (c) 2025 Kamil 'Novik' Nowicki <novik@axisos.org>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Website: https://axisos.org
+ * Repository: https://github.com/AxisOS/xfce4-axisclock-plugin
+ */
+
+#ifndef __DATE_UTILS_H__
+#define __DATE_UTILS_H__
+
+#include <glib.h>
+
+G_BEGIN_DECLS
+
+/*
+ * Proleptic Gregorian calendar arithmetic on day numbers, counted from
+ * 1970-01-01 = 0. Months are 1-12 and weekdays 0 = Sunday unless noted.
+ */
+gint32   axisclock_date_to_days        (gint    year,
+                                        gint    month,
+                                        gint    day);
+void     axisclock_date_from_days      (gint32  days,
+                                        gint   *year,
+                                        gint   *month,
+                                        gint   *day);
+gint     axisclock_date_weekday        (gint32  days);
+gboolean axisclock_date_is_leap_year   (gint    year);
+gint     axisclock_date_days_in_month  (gint    year,
+                                        gint    month);
+gint     axisclock_date_iso_week       (gint32  days);
+gint32   axisclock_date_easter         (gint    year);
+
+G_END_DECLS
+
+#endif /* !__DATE_UTILS_H__ */
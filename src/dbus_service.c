@@ -0,0 +1,223 @@
+/*
+ * xfce4-axisclock-plugin - A macOS-style clock plugin for the Xfce panel
+ *
+ * Copyright (c) 2025 Kamil 'Novik' Nowicki <novik@axisos.org>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Website: https://axisos.org
+ * Repository: https://github.com/AxisOS/xfce4-axisclock-plugin
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <gio/gio.h>
+
+#include "dbus_service.h"
+#include "clock_widget.h"
+#include "profiler.h"
+#include "tick_service.h"
+
+struct _AxisClockDBusService {
+    AxisClockPlugin *axisclock;
+    guint            owner_id;
+    GDBusConnection *connection;
+    guint            registration_id;
+    gchar           *object_path;
+};
+
+static const gchar introspection_xml[] =
+    "<node>"
+    "  <interface name='" AXISCLOCK_DBUS_INTERFACE "'>"
+    "    <method name='GetTime'>"
+    "      <arg type='s' name='text' direction='out'/>"
+    "    </method>"
+    "    <method name='GetBrokenDownTime'>"
+    "      <arg type='i' name='year' direction='out'/>"
+    "      <arg type='i' name='month' direction='out'/>"
+    "      <arg type='i' name='day' direction='out'/>"
+    "      <arg type='i' name='hour' direction='out'/>"
+    "      <arg type='i' name='minute' direction='out'/>"
+    "      <arg type='i' name='second' direction='out'/>"
+    "      <arg type='i' name='weekday' direction='out'/>"
+    "      <arg type='i' name='day_of_year' direction='out'/>"
+    "      <arg type='b' name='is_dst' direction='out'/>"
+    "    </method>"
+    "    <method name='GetZoneOffset'>"
+    "      <arg type='i' name='offset' direction='out'/>"
+    "      <arg type='s' name='abbreviation' direction='out'/>"
+    "    </method>"
+    "    <method name='GetNextBoundary'>"
+    "      <arg type='x' name='utc_seconds' direction='out'/>"
+    "    </method>"
+    "    <method name='DumpCounters'>"
+    "      <arg type='s' name='report' direction='out'/>"
+    "    </method>"
+    "    <signal name='Changed'>"
+    "      <arg type='s' name='text'/>"
+    "    </signal>"
+    "  </interface>"
+    "</node>";
+
+/* Parsed once, shared by every instance */
+static GDBusNodeInfo *introspection_data = NULL;
+
+static void
+handle_method_call(GDBusConnection *connection G_GNUC_UNUSED,
+                   const gchar *sender G_GNUC_UNUSED,
+                   const gchar *object_path G_GNUC_UNUSED,
+                   const gchar *interface_name G_GNUC_UNUSED,
+                   const gchar *method_name,
+                   GVariant *parameters G_GNUC_UNUSED,
+                   GDBusMethodInvocation *invocation,
+                   gpointer user_data)
+{
+    AxisClockDBusService *service = user_data;
+    AxisClockPlugin *axisclock = service->axisclock;
+    const struct tm *tm = &axisclock->last_tick.local_time;
+    
+    if (g_strcmp0(method_name, "GetTime") == 0) {
+        g_dbus_method_invocation_return_value(invocation,
+                                              g_variant_new("(s)", axisclock->last_text ? axisclock->last_text : ""));
+    } else if (g_strcmp0(method_name, "GetBrokenDownTime") == 0) {
+        g_dbus_method_invocation_return_value(invocation,
+                                              g_variant_new("(iiiiiiiib)", tm->tm_year + 1900, tm->tm_mon + 1,
+                                                            tm->tm_mday, tm->tm_hour, tm->tm_min, tm->tm_sec,
+                                                            tm->tm_wday, tm->tm_yday + 1, tm->tm_isdst > 0));
+    } else if (g_strcmp0(method_name, "GetZoneOffset") == 0) {
+        g_dbus_method_invocation_return_value(invocation,
+                                              g_variant_new("(is)", (gint32)tm->tm_gmtoff,
+                                                            tm->tm_zone ? tm->tm_zone : ""));
+    } else if (g_strcmp0(method_name, "GetNextBoundary") == 0) {
+        g_dbus_method_invocation_return_value(invocation,
+                                              g_variant_new("(x)", axisclock_tick_service_get_next_boundary()));
+    } else if (g_strcmp0(method_name, "DumpCounters") == 0) {
+#ifdef AXISCLOCK_ENABLE_PROFILING
+        gchar *report = axisclock_profiler_dump_to_string();
+        
+        g_dbus_method_invocation_return_value(invocation, g_variant_new("(s)", report));
+        g_free(report);
+#else
+        g_dbus_method_invocation_return_error(invocation, G_DBUS_ERROR, G_DBUS_ERROR_NOT_SUPPORTED,
+                                              "Built without -Dprofiling=true");
+#endif
+    } else {
+        g_dbus_method_invocation_return_error(invocation, G_DBUS_ERROR, G_DBUS_ERROR_UNKNOWN_METHOD,
+                                              "Unknown method %s", method_name);
+    }
+}
+
+static const GDBusInterfaceVTable interface_vtable = {
+    handle_method_call,
+    NULL,
+    NULL,
+    { NULL }
+};
+
+static void
+on_bus_acquired(GDBusConnection *connection, const gchar *name G_GNUC_UNUSED, gpointer user_data)
+{
+    AxisClockDBusService *service = user_data;
+    GError *error = NULL;
+    
+    service->registration_id = g_dbus_connection_register_object(connection, service->object_path,
+                                                                 introspection_data->interfaces[0],
+                                                                 &interface_vtable, service, NULL, &error);
+    if (service->registration_id == 0) {
+        g_warning("Cannot export %s: %s", service->object_path, error->message);
+        g_error_free(error);
+        return;
+    }
+    
+    service->connection = g_object_ref(connection);
+}
+
+static void
+on_name_lost(GDBusConnection *connection G_GNUC_UNUSED, const gchar *name, gpointer user_data G_GNUC_UNUSED)
+{
+    g_debug("D-Bus name %s not owned", name);
+}
+
+/**
+ * axisclock_dbus_service_new:
+ * @axisclock: The plugin instance to serve
+ * @unique_id: Panel unique id of the instance, used in the bus name and
+ *             object path
+ *
+ * Returns: A new #AxisClockDBusService; the name is acquired asynchronously.
+ */
+AxisClockDBusService *
+axisclock_dbus_service_new(AxisClockPlugin *axisclock, gint unique_id)
+{
+    AxisClockDBusService *service;
+    gchar *name;
+    
+    if (introspection_data == NULL)
+        introspection_data = g_dbus_node_info_new_for_xml(introspection_xml, NULL);
+    
+    service = g_new0(AxisClockDBusService, 1);
+    service->axisclock = axisclock;
+    /* Per instance: several plugins can share one process and connection */
+    service->object_path = g_strdup_printf(AXISCLOCK_DBUS_PATH_PREFIX "%d", unique_id);
+    
+    name = g_strdup_printf(AXISCLOCK_DBUS_NAME_PREFIX "%d", unique_id);
+    service->owner_id = g_bus_own_name(G_BUS_TYPE_SESSION, name, G_BUS_NAME_OWNER_FLAGS_NONE,
+                                       on_bus_acquired, NULL, on_name_lost, service, NULL);
+    g_free(name);
+    
+    return service;
+}
+
+/**
+ * axisclock_dbus_service_free:
+ * @service: A #AxisClockDBusService
+ *
+ * Unexports the object and releases the bus name.
+ */
+void
+axisclock_dbus_service_free(AxisClockDBusService *service)
+{
+    if (service == NULL)
+        return;
+    
+    g_bus_unown_name(service->owner_id);
+    if (service->connection != NULL) {
+        g_dbus_connection_unregister_object(service->connection, service->registration_id);
+        g_object_unref(service->connection);
+    }
+    g_free(service->object_path);
+    g_free(service);
+}
+
+/**
+ * axisclock_dbus_service_emit_changed:
+ * @service: A #AxisClockDBusService
+ * @text: The new label text
+ *
+ * Emits Changed; called only when the rendered text actually changed.
+ */
+void
+axisclock_dbus_service_emit_changed(AxisClockDBusService *service, const gchar *text)
+{
+    g_return_if_fail(service != NULL);
+    
+    if (service->connection == NULL)
+        return;
+    
+    g_dbus_connection_emit_signal(service->connection, NULL, service->object_path, AXISCLOCK_DBUS_INTERFACE,
+                                  "Changed", g_variant_new("(s)", text), NULL);
+}
@@ -0,0 +1,53 @@
+/*
+ * xfce4-axisclock-plugin - A macOS-style clock plugin for the Xfce panel
+ *
+ * Copyright (c) 2025 Kamil 'Novik' Nowicki <novik@axisos.org>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Website: https://axisos.org
+ * Repository: https://github.com/AxisOS/xfce4-axisclock-plugin
+ */
+
+#ifndef __DBUS_SERVICE_H__
+#define __DBUS_SERVICE_H__
+
+#include <glib.h>
+
+G_BEGIN_DECLS
+
+#define AXISCLOCK_DBUS_NAME_PREFIX  "org.axisos.AxisClock1.Plugin"
+#define AXISCLOCK_DBUS_PATH_PREFIX  "/org/axisos/AxisClock1/Plugin"
+#define AXISCLOCK_DBUS_INTERFACE    "org.axisos.AxisClock1"
+
+typedef struct _AxisClockDBusService AxisClockDBusService;
+
+struct _AxisClockPlugin;
+
+/*
+ * Session-bus query interface of one plugin instance, owned as
+ * org.axisos.AxisClock1.Plugin<unique id> and exported at
+ * /org/axisos/AxisClock1/Plugin<unique id>. Every method answers from what
+ * the last render already computed, so consumers add no clock work.
+ */
+AxisClockDBusService *axisclock_dbus_service_new          (struct _AxisClockPlugin *axisclock,
+                                                           gint                     unique_id);
+void                  axisclock_dbus_service_free         (AxisClockDBusService    *service);
+void                  axisclock_dbus_service_emit_changed (AxisClockDBusService    *service,
+                                                           const gchar             *text);
+
+G_END_DECLS
+
+#endif /* !__DBUS_SERVICE_H__ */
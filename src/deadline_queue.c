@@ -0,0 +1,371 @@
+/*
+ * xfce4-axisclock-plugin - A macOS-style clock plugin for the Xfce panel
+ *
+ * Copyright (c) 2025 Kamil 'Novik' Nowicki <novik@axisos.org>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Website: https://axisos.org
+ * Repository: https://github.com/AxisOS/xfce4-axisclock-plugin
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <glib.h>
+#include <glib-unix.h>
+#include <errno.h>
+#include <unistd.h>
+
+#ifdef HAVE_TIMERFD
+#include <sys/timerfd.h>
+#endif
+
+#include "deadline_queue.h"
+
+struct _AxisClockDeadline {
+    gint64                 when;
+    AxisClockDeadlineClock clock;
+    guint                  index;       /* Position in its heap */
+    AxisClockDeadlineFunc  func;
+    gpointer               user_data;
+};
+
+typedef struct {
+    GPtrArray *heaps[2];                /* Indexed by AxisClockDeadlineClock */
+    gint       fd;                      /* timerfd, -1 when unavailable */
+    guint      source_id;               /* fd watch or fallback timeout */
+    gboolean   dispatching;
+} DeadlineQueue;
+
+static DeadlineQueue *queue = NULL;
+
+static gint64
+deadline_clock_now(AxisClockDeadlineClock clock)
+{
+    return clock == AXISCLOCK_DEADLINE_REALTIME ? g_get_real_time() : g_get_monotonic_time();
+}
+
+static void
+heap_swap(GPtrArray *heap, guint a, guint b)
+{
+    AxisClockDeadline *tmp = heap->pdata[a];
+    
+    heap->pdata[a] = heap->pdata[b];
+    heap->pdata[b] = tmp;
+    ((AxisClockDeadline *)heap->pdata[a])->index = a;
+    ((AxisClockDeadline *)heap->pdata[b])->index = b;
+}
+
+static void
+heap_sift_up(GPtrArray *heap, guint index)
+{
+    while (index > 0) {
+        guint parent = (index - 1) / 2;
+        
+        if (((AxisClockDeadline *)heap->pdata[parent])->when <= ((AxisClockDeadline *)heap->pdata[index])->when)
+            break;
+        heap_swap(heap, parent, index);
+        index = parent;
+    }
+}
+
+static void
+heap_sift_down(GPtrArray *heap, guint index)
+{
+    for (;;) {
+        guint smallest = index;
+        guint left = 2 * index + 1;
+        guint right = left + 1;
+        
+        if (left < heap->len &&
+            ((AxisClockDeadline *)heap->pdata[left])->when < ((AxisClockDeadline *)heap->pdata[smallest])->when)
+            smallest = left;
+        if (right < heap->len &&
+            ((AxisClockDeadline *)heap->pdata[right])->when < ((AxisClockDeadline *)heap->pdata[smallest])->when)
+            smallest = right;
+        if (smallest == index)
+            break;
+        heap_swap(heap, index, smallest);
+        index = smallest;
+    }
+}
+
+/* Take @deadline out of its heap without freeing it */
+static void
+heap_remove(GPtrArray *heap, AxisClockDeadline *deadline)
+{
+    guint index = deadline->index;
+    guint last = heap->len - 1;
+    
+    if (index != last) {
+        heap_swap(heap, index, last);
+        g_ptr_array_remove_index(heap, last);
+        heap_sift_down(heap, index);
+        heap_sift_up(heap, index);
+    } else {
+        g_ptr_array_remove_index(heap, last);
+    }
+}
+
+static gboolean
+deadline_queue_is_empty(void)
+{
+    return queue->heaps[AXISCLOCK_DEADLINE_REALTIME]->len == 0 &&
+           queue->heaps[AXISCLOCK_DEADLINE_MONOTONIC]->len == 0;
+}
+
+static void
+deadline_queue_free(void)
+{
+    if (queue->source_id != 0)
+        g_source_remove(queue->source_id);
+    if (queue->fd >= 0)
+        close(queue->fd);
+    g_ptr_array_free(queue->heaps[AXISCLOCK_DEADLINE_REALTIME], TRUE);
+    g_ptr_array_free(queue->heaps[AXISCLOCK_DEADLINE_MONOTONIC], TRUE);
+    g_clear_pointer(&queue, g_free);
+}
+
+/* Earliest deadline of both heaps, as wall-clock microseconds */
+static gint64
+deadline_queue_next_realtime(void)
+{
+    GPtrArray *realtime = queue->heaps[AXISCLOCK_DEADLINE_REALTIME];
+    GPtrArray *monotonic = queue->heaps[AXISCLOCK_DEADLINE_MONOTONIC];
+    gint64 next = G_MAXINT64;
+    
+    if (realtime->len > 0)
+        next = ((AxisClockDeadline *)realtime->pdata[0])->when;
+    
+    /* Monotonic deadlines are converted at arm time; a clock change
+     * cancels the timer and they are converted again */
+    if (monotonic->len > 0) {
+        gint64 remaining = ((AxisClockDeadline *)monotonic->pdata[0])->when - g_get_monotonic_time();
+        
+        next = MIN(next, g_get_real_time() + remaining);
+    }
+    
+    return next;
+}
+
+static gboolean deadline_queue_timeout_cb(gpointer user_data);
+
+/* Arm the one timer for the earliest deadline, or disarm it */
+static void
+deadline_queue_arm(void)
+{
+    gint64 next = deadline_queue_is_empty() ? G_MAXINT64 : deadline_queue_next_realtime();
+    
+#ifdef HAVE_TIMERFD
+    if (queue->fd >= 0) {
+        struct itimerspec spec = { { 0, 0 }, { 0, 0 } };
+        
+        if (next != G_MAXINT64) {
+            /* An all-zero value would disarm; past deadlines fire at once */
+            next = MAX(next, 1);
+            spec.it_value.tv_sec = next / G_USEC_PER_SEC;
+            spec.it_value.tv_nsec = (next % G_USEC_PER_SEC) * 1000;
+        }
+        
+        if (timerfd_settime(queue->fd, TFD_TIMER_ABSTIME | TFD_TIMER_CANCEL_ON_SET, &spec, NULL) < 0)
+            g_warning("Cannot arm deadline timer: %s", g_strerror(errno));
+        return;
+    }
+#endif
+    
+    /* Fallback: a one-shot timeout, which misses wall-clock changes
+     * until it fires */
+    if (queue->source_id != 0) {
+        g_source_remove(queue->source_id);
+        queue->source_id = 0;
+    }
+    
+    if (next != G_MAXINT64) {
+        gint64 delay_ms = (next - g_get_real_time() + 999) / 1000;
+        
+        queue->source_id = g_timeout_add((guint)CLAMP(delay_ms, 0, G_MAXUINT), deadline_queue_timeout_cb, NULL);
+    }
+}
+
+/* Call every deadline that is due, earliest first */
+static void
+deadline_queue_dispatch(void)
+{
+    queue->dispatching = TRUE;
+    
+    for (;;) {
+        AxisClockDeadline *due = NULL;
+        
+        for (gint clock = 0; clock < 2; clock++) {
+            GPtrArray *heap = queue->heaps[clock];
+            AxisClockDeadline *top;
+            
+            if (heap->len == 0)
+                continue;
+            top = heap->pdata[0];
+            if (top->when <= deadline_clock_now(clock) && (due == NULL || top->when < due->when))
+                due = top;
+        }
+        
+        if (due == NULL)
+            break;
+        
+        /* Out of the heap before the call: the function may add new ones */
+        heap_remove(queue->heaps[due->clock], due);
+        due->func(due->user_data);
+        g_free(due);
+    }
+    
+    queue->dispatching = FALSE;
+}
+
+#ifdef HAVE_TIMERFD
+static gboolean
+deadline_queue_fd_cb(gint fd, GIOCondition condition G_GNUC_UNUSED, gpointer user_data G_GNUC_UNUSED)
+{
+    guint64 expirations;
+    
+    /* ECANCELED means the wall clock was set; re-evaluating is all we need */
+    if (read(fd, &expirations, sizeof(expirations)) < 0 && errno != ECANCELED && errno != EAGAIN)
+        g_warning("Cannot read deadline timer: %s", g_strerror(errno));
+    
+    deadline_queue_dispatch();
+    
+    if (deadline_queue_is_empty()) {
+        queue->source_id = 0;
+        deadline_queue_free();
+        return G_SOURCE_REMOVE;
+    }
+    
+    deadline_queue_arm();
+    return G_SOURCE_CONTINUE;
+}
+#endif
+
+static gboolean
+deadline_queue_timeout_cb(gpointer user_data G_GNUC_UNUSED)
+{
+    queue->source_id = 0;
+    deadline_queue_dispatch();
+    
+    if (deadline_queue_is_empty())
+        deadline_queue_free();
+    else
+        deadline_queue_arm();
+    
+    return G_SOURCE_REMOVE;
+}
+
+static void
+deadline_queue_ensure(void)
+{
+    if (queue != NULL)
+        return;
+    
+    queue = g_new0(DeadlineQueue, 1);
+    queue->heaps[AXISCLOCK_DEADLINE_REALTIME] = g_ptr_array_new();
+    queue->heaps[AXISCLOCK_DEADLINE_MONOTONIC] = g_ptr_array_new();
+    queue->fd = -1;
+    
+#ifdef HAVE_TIMERFD
+    queue->fd = timerfd_create(CLOCK_REALTIME, TFD_NONBLOCK | TFD_CLOEXEC);
+    if (queue->fd >= 0)
+        queue->source_id = g_unix_fd_add(queue->fd, G_IO_IN, deadline_queue_fd_cb, NULL);
+    else
+        g_warning("Cannot create deadline timer: %s", g_strerror(errno));
+#endif
+}
+
+/**
+ * axisclock_deadline_add:
+ * @clock: Clock @when is measured against
+ * @when: Absolute deadline in microseconds of @clock
+ * @func: Called once @when has passed
+ * @user_data: Passed to @func
+ *
+ * Returns: A handle for axisclock_deadline_remove(), valid until @func has
+ *          been called.
+ */
+AxisClockDeadline *
+axisclock_deadline_add(AxisClockDeadlineClock clock, gint64 when,
+                       AxisClockDeadlineFunc func, gpointer user_data)
+{
+    AxisClockDeadline *deadline;
+    GPtrArray *heap;
+    
+    g_return_val_if_fail(func != NULL, NULL);
+    
+    deadline_queue_ensure();
+    
+    deadline = g_new0(AxisClockDeadline, 1);
+    deadline->when = when;
+    deadline->clock = clock;
+    deadline->func = func;
+    deadline->user_data = user_data;
+    
+    heap = queue->heaps[clock];
+    deadline->index = heap->len;
+    g_ptr_array_add(heap, deadline);
+    heap_sift_up(heap, deadline->index);
+    
+    /* Only a new earliest deadline moves the timer; dispatch re-arms anyway */
+    if (deadline->index == 0 && !queue->dispatching)
+        deadline_queue_arm();
+    
+    return deadline;
+}
+
+/**
+ * axisclock_deadline_remove:
+ * @deadline: A pending deadline
+ *
+ * Cancels and frees @deadline.
+ */
+void
+axisclock_deadline_remove(AxisClockDeadline *deadline)
+{
+    gboolean was_first;
+    
+    g_return_if_fail(deadline != NULL);
+    g_return_if_fail(queue != NULL);
+    
+    was_first = deadline->index == 0;
+    heap_remove(queue->heaps[deadline->clock], deadline);
+    g_free(deadline);
+    
+    if (queue->dispatching)
+        return;
+    
+    if (deadline_queue_is_empty())
+        deadline_queue_free();
+    else if (was_first)
+        deadline_queue_arm();
+}
+
+/**
+ * axisclock_deadline_get_time:
+ * @deadline: A pending deadline
+ *
+ * Returns: The absolute deadline, in microseconds of its clock.
+ */
+gint64
+axisclock_deadline_get_time(const AxisClockDeadline *deadline)
+{
+    g_return_val_if_fail(deadline != NULL, 0);
+    
+    return deadline->when;
+}
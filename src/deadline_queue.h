@@ -0,0 +1,57 @@
+/*
+ * xfce4-axisclock-plugin - A macOS-style clock plugin for the Xfce panel
+ *
+ * Copyright (c) 2025 Kamil 'Novik' Nowicki <novik@axisos.org>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Website: https://axisos.org
+ * Repository: https://github.com/AxisOS/xfce4-axisclock-plugin
+ */
+
+#ifndef __DEADLINE_QUEUE_H__
+#define __DEADLINE_QUEUE_H__
+
+#include <glib.h>
+
+G_BEGIN_DECLS
+
+/* Clock a deadline is measured against */
+typedef enum {
+    AXISCLOCK_DEADLINE_REALTIME,    /* Wall clock, follows clock changes */
+    AXISCLOCK_DEADLINE_MONOTONIC    /* Elapsed time, ignores clock changes */
+} AxisClockDeadlineClock;
+
+typedef struct _AxisClockDeadline AxisClockDeadline;
+
+typedef void (*AxisClockDeadlineFunc) (gpointer user_data);
+
+/*
+ * Process-wide queue of absolute deadlines, in microseconds of
+ * g_get_real_time() or g_get_monotonic_time(). Each clock has a min-heap
+ * and only the earliest deadline overall is armed, on a single timerfd
+ * where available, so pending deadlines cost no wakeups until one is due.
+ * A deadline handle is freed once its function has been called.
+ */
+AxisClockDeadline *axisclock_deadline_add      (AxisClockDeadlineClock  clock,
+                                                gint64                  when,
+                                                AxisClockDeadlineFunc   func,
+                                                gpointer                user_data);
+void               axisclock_deadline_remove   (AxisClockDeadline      *deadline);
+gint64             axisclock_deadline_get_time (const AxisClockDeadline *deadline);
+
+G_END_DECLS
+
+#endif /* !__DEADLINE_QUEUE_H__ */
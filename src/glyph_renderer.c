@@ -0,0 +1,402 @@
+/*
+ * xfce4-axisclock-plugin - A macOS-style clock plugin for the Xfce panel
+ *
+ * Copyright (c) 2025 Kamil 'Novik' Nowicki <novik@axisos.org>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Website: https://axisos.org
+ * Repository: https://github.com/AxisOS/xfce4-axisclock-plugin
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <string.h>
+#include <gtk/gtk.h>
+
+#include "glyph_renderer.h"
+#include "locale_cache.h"
+#include "profiler.h"
+
+/* Atlas width, in logical pixels, past which it is rebuilt from scratch */
+#define ATLAS_MAX_WIDTH 4096
+
+/* One rasterized cell in the atlas */
+typedef struct {
+    gint x;                         /* Left edge in the atlas */
+    gint width;
+} AtlasGlyph;
+
+/* One cell of the text currently shown */
+typedef struct {
+    const AtlasGlyph *glyph;
+    gint              x;
+} TextCell;
+
+struct _AxisClockGlyphRenderer {
+    GtkWidget       *area;
+    
+    /* Atlas surface and the font, scale and color it was rasterized for */
+    cairo_surface_t *atlas;
+    gint             atlas_used;
+    gint             atlas_capacity;
+    gint             scale;
+    gint             ascent;
+    gint             height;
+    gint             digit_width;   /* Widest digit, used for every digit */
+    GdkRGBA          color;
+    GHashTable      *glyphs;        /* cell text -> AtlasGlyph */
+    
+    /* Current text split into cells */
+    GArray          *cells;         /* TextCell */
+    gint             width;
+    gchar           *text;
+};
+
+/* Separators pre-rasterized together with the digits */
+static const gchar *const atlas_separators[] = { ":", ".", ",", " ", "/", "-" };
+
+static gboolean
+is_digit_cell(const gchar *key)
+{
+    return key[0] >= '0' && key[0] <= '9' && key[1] == '\0';
+}
+
+/* Make room for at least @needed logical pixels, keeping what is drawn */
+static void
+atlas_grow(AxisClockGlyphRenderer *renderer, gint needed)
+{
+    gint capacity = MAX(renderer->atlas_capacity * 2, needed);
+    cairo_surface_t *surface;
+    
+    surface = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, capacity * renderer->scale,
+                                         MAX(renderer->height, 1) * renderer->scale);
+    cairo_surface_set_device_scale(surface, renderer->scale, renderer->scale);
+    
+    if (renderer->atlas != NULL) {
+        cairo_t *cr = cairo_create(surface);
+        
+        cairo_set_operator(cr, CAIRO_OPERATOR_SOURCE);
+        cairo_set_source_surface(cr, renderer->atlas, 0, 0);
+        cairo_paint(cr);
+        cairo_destroy(cr);
+        cairo_surface_destroy(renderer->atlas);
+    }
+    
+    renderer->atlas = surface;
+    renderer->atlas_capacity = capacity;
+}
+
+/* Return the atlas cell for @length bytes of @key, shaping and rasterizing
+ * it on first use */
+static const AtlasGlyph *
+atlas_lookup(AxisClockGlyphRenderer *renderer, const gchar *key, gsize length)
+{
+    gchar *owned = g_strndup(key, length);
+    AtlasGlyph *glyph = g_hash_table_lookup(renderer->glyphs, owned);
+    PangoLayout *layout;
+    PangoRectangle logical;
+    cairo_t *cr;
+    
+    if (glyph != NULL) {
+        g_free(owned);
+        return glyph;
+    }
+    
+    layout = gtk_widget_create_pango_layout(renderer->area, owned);
+    pango_layout_get_pixel_extents(layout, NULL, &logical);
+    
+    glyph = g_new(AtlasGlyph, 1);
+    glyph->x = renderer->atlas_used;
+    glyph->width = is_digit_cell(owned) ? renderer->digit_width : logical.width;
+    
+    if (glyph->x + glyph->width > renderer->atlas_capacity)
+        atlas_grow(renderer, glyph->x + glyph->width);
+    
+    /* Clip to the cell so overhanging ink cannot bleed into a neighbour */
+    cr = cairo_create(renderer->atlas);
+    cairo_rectangle(cr, glyph->x, 0, glyph->width, renderer->height);
+    cairo_clip(cr);
+    gdk_cairo_set_source_rgba(cr, &renderer->color);
+    cairo_move_to(cr, glyph->x + (glyph->width - logical.width) / 2 - logical.x,
+                  renderer->ascent - pango_layout_get_baseline(layout) / PANGO_SCALE);
+    pango_cairo_show_layout(cr, layout);
+    cairo_destroy(cr);
+    g_object_unref(layout);
+    
+    renderer->atlas_used += glyph->width;
+    g_hash_table_insert(renderer->glyphs, owned, glyph);
+    
+    return glyph;
+}
+
+/* Drop the atlas and rasterize digits, separators and AM/PM for the
+ * current font, scale factor and theme color */
+static void
+atlas_reset(AxisClockGlyphRenderer *renderer)
+{
+    PangoContext *context = gtk_widget_get_pango_context(renderer->area);
+    PangoFontMetrics *metrics;
+    const AxisClockLocale *locale = axisclock_locale_get();
+    const AxisClockLocaleString *markers[] = { &locale->am, &locale->pm };
+    
+    g_clear_pointer(&renderer->atlas, cairo_surface_destroy);
+    g_hash_table_remove_all(renderer->glyphs);
+    g_array_set_size(renderer->cells, 0);
+    renderer->atlas_used = 0;
+    renderer->atlas_capacity = 0;
+    
+    metrics = pango_context_get_metrics(context, pango_context_get_font_description(context), NULL);
+    renderer->ascent = PANGO_PIXELS_CEIL(pango_font_metrics_get_ascent(metrics));
+    renderer->height = renderer->ascent + PANGO_PIXELS_CEIL(pango_font_metrics_get_descent(metrics));
+    pango_font_metrics_unref(metrics);
+    
+    renderer->scale = gtk_widget_get_scale_factor(renderer->area);
+    gtk_style_context_get_color(gtk_widget_get_style_context(renderer->area),
+                                gtk_widget_get_state_flags(renderer->area), &renderer->color);
+    
+    /* Digits are tabular so a changing digit never moves its neighbours */
+    renderer->digit_width = 0;
+    for (gchar digit[2] = "0"; digit[0] <= '9'; digit[0]++) {
+        PangoLayout *layout = gtk_widget_create_pango_layout(renderer->area, digit);
+        PangoRectangle logical;
+        
+        pango_layout_get_pixel_extents(layout, NULL, &logical);
+        renderer->digit_width = MAX(renderer->digit_width, logical.width);
+        g_object_unref(layout);
+    }
+    
+    atlas_grow(renderer, renderer->digit_width * 16);
+    
+    for (gchar digit[2] = "0"; digit[0] <= '9'; digit[0]++)
+        atlas_lookup(renderer, digit, 1);
+    for (guint i = 0; i < G_N_ELEMENTS(atlas_separators); i++)
+        atlas_lookup(renderer, atlas_separators[i], strlen(atlas_separators[i]));
+    
+    for (guint i = 0; i < G_N_ELEMENTS(markers); i++) {
+        gchar *upper;
+        
+        if (markers[i]->length == 0)
+            continue;
+        
+        upper = g_utf8_strup(markers[i]->text, markers[i]->length);
+        atlas_lookup(renderer, markers[i]->text, markers[i]->length);
+        atlas_lookup(renderer, upper, strlen(upper));
+        g_free(upper);
+    }
+}
+
+/* Top-left corner of the text inside the allocation */
+static void
+renderer_get_origin(AxisClockGlyphRenderer *renderer, gint *x, gint *y)
+{
+    *x = (gtk_widget_get_allocated_width(renderer->area) - renderer->width) / 2;
+    *y = (gtk_widget_get_allocated_height(renderer->area) - renderer->height) / 2;
+}
+
+/* Blit the cells that intersect the damaged area */
+static gboolean
+renderer_draw_cb(GtkWidget *widget G_GNUC_UNUSED, cairo_t *cr, gpointer data)
+{
+    AxisClockGlyphRenderer *renderer = (AxisClockGlyphRenderer *)data;
+    GdkRectangle clip;
+    gint origin_x, origin_y;
+    
+    if (renderer->atlas == NULL || !gdk_cairo_get_clip_rectangle(cr, &clip))
+        return FALSE;
+    
+    AXISCLOCK_PROBE_BEGIN(probe_start);
+    
+    renderer_get_origin(renderer, &origin_x, &origin_y);
+    
+    for (guint i = 0; i < renderer->cells->len; i++) {
+        const TextCell *cell = &g_array_index(renderer->cells, TextCell, i);
+        gint x = origin_x + cell->x;
+        
+        if (x + cell->glyph->width <= clip.x || x >= clip.x + clip.width)
+            continue;
+        
+        cairo_set_source_surface(cr, renderer->atlas, x - cell->glyph->x, origin_y);
+        cairo_rectangle(cr, x, origin_y, cell->glyph->width, renderer->height);
+        cairo_fill(cr);
+    }
+    
+    AXISCLOCK_PROBE_END(AXISCLOCK_PROBE_GLYPH_DRAW, probe_start);
+    
+    return FALSE;
+}
+
+/**
+ * axisclock_glyph_renderer_new:
+ *
+ * Returns: A new #AxisClockGlyphRenderer; the atlas is built on the first
+ * text.
+ */
+AxisClockGlyphRenderer *
+axisclock_glyph_renderer_new(void)
+{
+    AxisClockGlyphRenderer *renderer = g_new0(AxisClockGlyphRenderer, 1);
+    
+    renderer->area = g_object_ref_sink(gtk_drawing_area_new());
+    renderer->glyphs = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, g_free);
+    renderer->cells = g_array_new(FALSE, FALSE, sizeof(TextCell));
+    
+    g_signal_connect(renderer->area, "draw", G_CALLBACK(renderer_draw_cb), renderer);
+    
+    return renderer;
+}
+
+/**
+ * axisclock_glyph_renderer_free:
+ * @renderer: A #AxisClockGlyphRenderer
+ *
+ * Frees the atlas and drops the reference on the drawing area.
+ */
+void
+axisclock_glyph_renderer_free(AxisClockGlyphRenderer *renderer)
+{
+    if (renderer == NULL)
+        return;
+    
+    g_signal_handlers_disconnect_by_data(renderer->area, renderer);
+    g_object_unref(renderer->area);
+    g_clear_pointer(&renderer->atlas, cairo_surface_destroy);
+    g_hash_table_destroy(renderer->glyphs);
+    g_array_free(renderer->cells, TRUE);
+    g_free(renderer->text);
+    g_free(renderer);
+}
+
+/**
+ * axisclock_glyph_renderer_get_widget:
+ * @renderer: A #AxisClockGlyphRenderer
+ *
+ * Returns: (transfer none): The drawing area to pack into the panel.
+ */
+GtkWidget *
+axisclock_glyph_renderer_get_widget(AxisClockGlyphRenderer *renderer)
+{
+    g_return_val_if_fail(renderer != NULL, NULL);
+    
+    return renderer->area;
+}
+
+/**
+ * axisclock_glyph_renderer_set_text:
+ * @renderer: A #AxisClockGlyphRenderer
+ * @text: Text to show
+ *
+ * Splits @text into cells (single digits and separators, whole words) and
+ * invalidates only the cells that differ from the previous text. The whole
+ * area is redrawn only when the total width or the atlas changed.
+ */
+void
+axisclock_glyph_renderer_set_text(AxisClockGlyphRenderer *renderer, const gchar *text)
+{
+    GArray *cells;
+    gboolean full = FALSE;
+    gint width = 0;
+    
+    g_return_if_fail(renderer != NULL);
+    
+    if (text == NULL)
+        text = "";
+    
+    if (renderer->atlas != NULL && g_strcmp0(text, renderer->text) == 0)
+        return;
+    
+    if (renderer->atlas == NULL || renderer->atlas_used > ATLAS_MAX_WIDTH) {
+        atlas_reset(renderer);
+        full = TRUE;
+    }
+    
+    cells = g_array_sized_new(FALSE, FALSE, sizeof(TextCell), renderer->cells->len);
+    
+    for (const gchar *p = text; *p != '\0';) {
+        const gchar *end = g_utf8_next_char(p);
+        TextCell cell;
+        
+        /* Letters are shaped as whole words, everything else per character */
+        if (g_unichar_isalpha(g_utf8_get_char(p))) {
+            while (*end != '\0') {
+                gunichar c = g_utf8_get_char(end);
+                
+                if (!g_unichar_isalpha(c) && !g_unichar_ismark(c))
+                    break;
+                end = g_utf8_next_char(end);
+            }
+        }
+        
+        cell.glyph = atlas_lookup(renderer, p, end - p);
+        cell.x = width;
+        width += cell.glyph->width;
+        g_array_append_val(cells, cell);
+        p = end;
+    }
+    
+    if (full || width != renderer->width) {
+        gtk_widget_set_size_request(renderer->area, width, renderer->height);
+        gtk_widget_queue_draw(renderer->area);
+    } else {
+        gint origin_x, origin_y;
+        
+        renderer_get_origin(renderer, &origin_x, &origin_y);
+        
+        for (guint i = 0; i < MAX(cells->len, renderer->cells->len); i++) {
+            const TextCell *old = i < renderer->cells->len ? &g_array_index(renderer->cells, TextCell, i) : NULL;
+            const TextCell *new = i < cells->len ? &g_array_index(cells, TextCell, i) : NULL;
+            
+            if (old != NULL && new != NULL && old->glyph == new->glyph && old->x == new->x)
+                continue;
+            
+            AXISCLOCK_COUNT(AXISCLOCK_COUNTER_GLYPH_CELLS);
+            
+            if (old != NULL)
+                gtk_widget_queue_draw_area(renderer->area, origin_x + old->x, origin_y,
+                                           old->glyph->width, renderer->height);
+            if (new != NULL && (old == NULL || old->x != new->x || old->glyph->width != new->glyph->width))
+                gtk_widget_queue_draw_area(renderer->area, origin_x + new->x, origin_y,
+                                           new->glyph->width, renderer->height);
+        }
+    }
+    
+    g_array_free(renderer->cells, TRUE);
+    renderer->cells = cells;
+    renderer->width = width;
+    g_free(renderer->text);
+    renderer->text = g_strdup(text);
+}
+
+/**
+ * axisclock_glyph_renderer_invalidate:
+ * @renderer: A #AxisClockGlyphRenderer
+ *
+ * Rasterizes the atlas again for the current font, scale factor and theme
+ * color, and redraws the current text.
+ */
+void
+axisclock_glyph_renderer_invalidate(AxisClockGlyphRenderer *renderer)
+{
+    gchar *text;
+    
+    g_return_if_fail(renderer != NULL);
+    
+    text = g_steal_pointer(&renderer->text);
+    g_clear_pointer(&renderer->atlas, cairo_surface_destroy);
+    axisclock_glyph_renderer_set_text(renderer, text);
+    g_free(text);
+}
@@ -0,0 +1,50 @@
+/*
+ * xfce4-axisclock-plugin - A macOS-style clock plugin for the Xfce panel
+ *
+ * Copyright (c) 2025 Kamil 'Novik' Nowicki <novik@axisos.org>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Website: https://axisos.org
+ * Repository: https://github.com/AxisOS/xfce4-axisclock-plugin
+ */
+
+#ifndef __GLYPH_RENDERER_H__
+#define __GLYPH_RENDERER_H__
+
+#include <gtk/gtk.h>
+
+G_BEGIN_DECLS
+
+typedef struct _AxisClockGlyphRenderer AxisClockGlyphRenderer;
+
+/*
+ * A drawing area that shows the clock text from a glyph atlas. Digits,
+ * separators and words (AM/PM, day names) are each shaped and rasterized
+ * once per font, scale factor and theme; digits share one tabular width so
+ * the layout never shifts. Setting new text only blits the cells that
+ * changed and invalidates just their rectangles. The owner calls
+ * axisclock_glyph_renderer_invalidate() when any of those change.
+ */
+AxisClockGlyphRenderer *axisclock_glyph_renderer_new        (void);
+void                    axisclock_glyph_renderer_free       (AxisClockGlyphRenderer *renderer);
+GtkWidget              *axisclock_glyph_renderer_get_widget (AxisClockGlyphRenderer *renderer);
+void                    axisclock_glyph_renderer_set_text   (AxisClockGlyphRenderer *renderer,
+                                                             const gchar            *text);
+void                    axisclock_glyph_renderer_invalidate (AxisClockGlyphRenderer *renderer);
+
+G_END_DECLS
+
+#endif /* !__GLYPH_RENDERER_H__ */
@@ -0,0 +1,322 @@
+/*
+ * xfce4-axisclock-plugin - A macOS-style clock plugin for the Xfce panel
+ *
+ * Copyright (c) 2025 Kamil 'Novik' Nowicki <novik@axisos.org>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Website: https://axisos.org
+ * Repository: https://github.com/AxisOS/xfce4-axisclock-plugin
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <glib.h>
+#include <string.h>
+
+#include "holidays.h"
+#include "date_utils.h"
+
+/* Expanded years kept */
+#define HOLIDAY_CACHE_SIZE 4
+
+typedef enum {
+    RULE_FIXED,         /* @month/@day */
+    RULE_NTH_WEEKDAY,   /* @day-th @weekday of @month, negative from the end */
+    RULE_EASTER         /* @offset days from Easter Sunday */
+} HolidayRuleKind;
+
+typedef struct {
+    guint8       kind;
+    guint8       month;
+    gint8        day;
+    guint8       weekday;   /* 0 = Sunday */
+    gint16       offset;
+    guint16      since;     /* First year observed, 0 for always */
+    const gchar *name;
+} HolidayRule;
+
+#define FIXED(m, d, name)           { RULE_FIXED, m, d, 0, 0, 0, name }
+#define FIXED_SINCE(m, d, y, name)  { RULE_FIXED, m, d, 0, 0, y, name }
+#define NTH(m, n, wd, name)         { RULE_NTH_WEEKDAY, m, n, wd, 0, 0, name }
+#define EASTER(off, name)           { RULE_EASTER, 0, 0, 0, off, 0, name }
+
+enum { SUN, MON, TUE, WED, THU, FRI, SAT };
+
+static const HolidayRule rules_us[] = {
+    FIXED(1, 1, "New Year's Day"),
+    NTH(1, 3, MON, "Martin Luther King Jr. Day"),
+    NTH(2, 3, MON, "Washington's Birthday"),
+    NTH(5, -1, MON, "Memorial Day"),
+    FIXED_SINCE(6, 19, 2021, "Juneteenth"),
+    FIXED(7, 4, "Independence Day"),
+    NTH(9, 1, MON, "Labor Day"),
+    NTH(10, 2, MON, "Columbus Day"),
+    FIXED(11, 11, "Veterans Day"),
+    NTH(11, 4, THU, "Thanksgiving Day"),
+    FIXED(12, 25, "Christmas Day"),
+};
+
+static const HolidayRule rules_gb[] = {
+    FIXED(1, 1, "New Year's Day"),
+    EASTER(-2, "Good Friday"),
+    EASTER(1, "Easter Monday"),
+    NTH(5, 1, MON, "Early May Bank Holiday"),
+    NTH(5, -1, MON, "Spring Bank Holiday"),
+    NTH(8, -1, MON, "Summer Bank Holiday"),
+    FIXED(12, 25, "Christmas Day"),
+    FIXED(12, 26, "Boxing Day"),
+};
+
+static const HolidayRule rules_de[] = {
+    FIXED(1, 1, "New Year's Day"),
+    EASTER(-2, "Good Friday"),
+    EASTER(1, "Easter Monday"),
+    FIXED(5, 1, "Labour Day"),
+    EASTER(39, "Ascension Day"),
+    EASTER(50, "Whit Monday"),
+    FIXED(10, 3, "German Unity Day"),
+    FIXED(12, 25, "Christmas Day"),
+    FIXED(12, 26, "Second Day of Christmas"),
+};
+
+static const HolidayRule rules_fr[] = {
+    FIXED(1, 1, "New Year's Day"),
+    EASTER(1, "Easter Monday"),
+    FIXED(5, 1, "Labour Day"),
+    FIXED(5, 8, "Victory in Europe Day"),
+    EASTER(39, "Ascension Day"),
+    EASTER(50, "Whit Monday"),
+    FIXED(7, 14, "Bastille Day"),
+    FIXED(8, 15, "Assumption Day"),
+    FIXED(11, 1, "All Saints' Day"),
+    FIXED(11, 11, "Armistice Day"),
+    FIXED(12, 25, "Christmas Day"),
+};
+
+static const HolidayRule rules_pl[] = {
+    FIXED(1, 1, "New Year's Day"),
+    FIXED(1, 6, "Epiphany"),
+    EASTER(0, "Easter Sunday"),
+    EASTER(1, "Easter Monday"),
+    FIXED(5, 1, "Labour Day"),
+    FIXED(5, 3, "Constitution Day"),
+    EASTER(49, "Pentecost"),
+    EASTER(60, "Corpus Christi"),
+    FIXED(8, 15, "Assumption Day"),
+    FIXED(11, 1, "All Saints' Day"),
+    FIXED(11, 11, "Independence Day"),
+    FIXED_SINCE(12, 24, 2025, "Christmas Eve"),
+    FIXED(12, 25, "Christmas Day"),
+    FIXED(12, 26, "Second Day of Christmas"),
+};
+
+typedef struct {
+    const gchar       *code;
+    const gchar       *name;
+    const HolidayRule *rules;
+    guint              n_rules;
+} HolidayCountry;
+
+static const HolidayCountry countries[] = {
+    { "US", "United States", rules_us, G_N_ELEMENTS(rules_us) },
+    { "GB", "United Kingdom", rules_gb, G_N_ELEMENTS(rules_gb) },
+    { "DE", "Germany", rules_de, G_N_ELEMENTS(rules_de) },
+    { "FR", "France", rules_fr, G_N_ELEMENTS(rules_fr) },
+    { "PL", "Poland", rules_pl, G_N_ELEMENTS(rules_pl) },
+};
+
+/* One country's holidays for one year, by day of year (0-365) */
+typedef struct {
+    const HolidayCountry *country;
+    gint                  year;
+    guint64               last_used;
+    guint32               bitmap[12];   /* 384 bits >= 366 days */
+    guint8                names[366];   /* Rule index + 1, 0 for none */
+} HolidayYear;
+
+static HolidayYear holiday_cache[HOLIDAY_CACHE_SIZE];
+static guint64 holiday_clock;
+
+static const HolidayCountry *
+holidays_find_country(const gchar *code)
+{
+    if (code == NULL || *code == '\0')
+        return NULL;
+    
+    for (guint i = 0; i < G_N_ELEMENTS(countries); i++)
+        if (g_ascii_strcasecmp(countries[i].code, code) == 0)
+            return &countries[i];
+    
+    return NULL;
+}
+
+/* Day number a rule falls on in @year */
+static gint32
+holiday_rule_evaluate(const HolidayRule *rule, gint year)
+{
+    gint32 first, last;
+    
+    switch (rule->kind) {
+        case RULE_FIXED:
+            return axisclock_date_to_days(year, rule->month, rule->day);
+        
+        case RULE_NTH_WEEKDAY:
+            if (rule->day > 0) {
+                first = axisclock_date_to_days(year, rule->month, 1);
+                return first + (rule->weekday - axisclock_date_weekday(first) + 7) % 7 + (rule->day - 1) * 7;
+            }
+            last = axisclock_date_to_days(year, rule->month, axisclock_date_days_in_month(year, rule->month));
+            return last - (axisclock_date_weekday(last) - rule->weekday + 7) % 7 + (rule->day + 1) * 7;
+        
+        case RULE_EASTER:
+        default:
+            return axisclock_date_easter(year) + rule->offset;
+    }
+}
+
+/* Expand every rule of @country once for @year */
+static void
+holiday_year_expand(HolidayYear *entry, const HolidayCountry *country, gint year)
+{
+    gint32 new_year = axisclock_date_to_days(year, 1, 1);
+    
+    memset(entry, 0, sizeof(*entry));
+    entry->country = country;
+    entry->year = year;
+    
+    for (guint i = 0; i < country->n_rules; i++) {
+        const HolidayRule *rule = &country->rules[i];
+        gint32 day_of_year;
+        
+        if (rule->since != 0 && year < rule->since)
+            continue;
+        
+        day_of_year = holiday_rule_evaluate(rule, year) - new_year;
+        if (day_of_year < 0 || day_of_year >= 366)
+            continue;
+        
+        entry->bitmap[day_of_year / 32] |= 1u << (day_of_year % 32);
+        if (entry->names[day_of_year] == 0)
+            entry->names[day_of_year] = (guint8)(i + 1);
+    }
+}
+
+/* Cached expansion of (@country, @year), evicting the least recently used */
+static const HolidayYear *
+holidays_get_year(const HolidayCountry *country, gint year)
+{
+    HolidayYear *victim = &holiday_cache[0];
+    
+    for (guint i = 0; i < HOLIDAY_CACHE_SIZE; i++) {
+        HolidayYear *entry = &holiday_cache[i];
+        
+        if (entry->country == country && entry->year == year) {
+            entry->last_used = ++holiday_clock;
+            return entry;
+        }
+        if (entry->last_used < victim->last_used)
+            victim = entry;
+    }
+    
+    holiday_year_expand(victim, country, year);
+    victim->last_used = ++holiday_clock;
+    
+    return victim;
+}
+
+/**
+ * axisclock_holidays_country_code:
+ * @index: Index into the built-in country list
+ *
+ * Returns: ISO 3166 code of the country, or %NULL past the end of the list.
+ */
+const gchar *
+axisclock_holidays_country_code(guint index)
+{
+    return index < G_N_ELEMENTS(countries) ? countries[index].code : NULL;
+}
+
+/**
+ * axisclock_holidays_country_name:
+ * @index: Index into the built-in country list
+ *
+ * Returns: English name of the country, or %NULL past the end of the list.
+ */
+const gchar *
+axisclock_holidays_country_name(guint index)
+{
+    return index < G_N_ELEMENTS(countries) ? countries[index].name : NULL;
+}
+
+/**
+ * axisclock_holidays_get_month_mask:
+ * @country: ISO 3166 code, or %NULL
+ * @year: Year
+ * @month: Month, 1-12
+ *
+ * Returns: Bit (day - 1) set for every public holiday of the month.
+ */
+guint32
+axisclock_holidays_get_month_mask(const gchar *country, gint year, gint month)
+{
+    const HolidayCountry *found = holidays_find_country(country);
+    const HolidayYear *entry;
+    guint first, dim;
+    guint64 window;
+    
+    if (found == NULL)
+        return 0;
+    
+    entry = holidays_get_year(found, year);
+    first = axisclock_date_to_days(year, month, 1) - axisclock_date_to_days(year, 1, 1);
+    dim = axisclock_date_days_in_month(year, month);
+    
+    /* The month's slice of the bitmap spans at most two words */
+    window = entry->bitmap[first / 32];
+    if (first / 32 + 1 < G_N_ELEMENTS(entry->bitmap))
+        window |= (guint64)entry->bitmap[first / 32 + 1] << 32;
+    
+    return (guint32)(window >> (first % 32)) & (guint32)((G_GUINT64_CONSTANT(1) << dim) - 1);
+}
+
+/**
+ * axisclock_holidays_get_name:
+ * @country: ISO 3166 code, or %NULL
+ * @year: Year
+ * @month: Month, 1-12
+ * @day: Day of the month
+ *
+ * Returns: Name of the holiday on that day, or %NULL.
+ */
+const gchar *
+axisclock_holidays_get_name(const gchar *country, gint year, gint month, gint day)
+{
+    const HolidayCountry *found = holidays_find_country(country);
+    const HolidayYear *entry;
+    gint32 day_of_year;
+    
+    if (found == NULL)
+        return NULL;
+    
+    entry = holidays_get_year(found, year);
+    day_of_year = axisclock_date_to_days(year, month, day) - axisclock_date_to_days(year, 1, 1);
+    if (day_of_year < 0 || day_of_year >= 366 || entry->names[day_of_year] == 0)
+        return NULL;
+    
+    return found->rules[entry->names[day_of_year] - 1].name;
+}
@@ -0,0 +1,49 @@
+/*
+ * xfce4-axisclock-plugin - A macOS-style clock plugin for the Xfce panel
+ *
+ * Copyright (c) 2025 Kamil 'Novik' Nowicki <novik@axisos.org>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Website: https://axisos.org
+ * Repository: https://github.com/AxisOS/xfce4-axisclock-plugin
+ */
+
+#ifndef __HOLIDAYS_H__
+#define __HOLIDAYS_H__
+
+#include <glib.h>
+
+G_BEGIN_DECLS
+
+/*
+ * Public holidays from rule tables compiled into the plugin. Each viewed
+ * (country, year) is expanded once into a day-of-year bitmap and name
+ * index; a few recent years are kept, so paging never re-evaluates the
+ * rules. Countries are identified by ISO 3166 code, months are 1-12.
+ */
+const gchar *axisclock_holidays_country_code (guint        index);
+const gchar *axisclock_holidays_country_name (guint        index);
+guint32      axisclock_holidays_get_month_mask (const gchar *country,
+                                                gint         year,
+                                                gint         month);
+const gchar *axisclock_holidays_get_name     (const gchar *country,
+                                              gint         year,
+                                              gint         month,
+                                              gint         day);
+
+G_END_DECLS
+
+#endif /* !__HOLIDAYS_H__ */
@@ -0,0 +1,890 @@
+/*
+ * xfce4-axisclock-plugin - A macOS-style clock plugin for the Xfce panel
+ *
+ * Copyright (c) 2025 Kamil 'Novik' Nowicki <novik@axisos.org>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Website: https://axisos.org
+ * Repository: https://github.com/AxisOS/xfce4-axisclock-plugin
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <glib.h>
+#include <gio/gio.h>
+#include <string.h>
+#include <time.h>
+
+#include "ics_events.h"
+#include "date_utils.h"
+
+/* One-off events longer than this are clipped */
+#define ICS_MAX_SPAN_DAYS 366
+
+/* Recurring events longer than this are clipped, bounds the scan window */
+#define ICS_MAX_RECURRING_SPAN 31
+
+/* How far ahead COUNT is resolved into a last day; later occurrences of
+ * rules with a larger COUNT are all shown */
+#define ICS_COUNT_HORIZON_DAYS (100 * 366)
+
+/* BYDAY ordinals of one weekday: every occurrence, "1MO".."5MO" in bits 1-5
+ * and "-1MO".."-5MO" in bits 6-10 */
+#define ICS_NTH_EVERY 1u
+#define ICS_NTH_BIT(nth) ((nth) > 0 ? 1u << (nth) : 1u << (5 - (nth)))
+
+typedef enum {
+    ICS_FREQ_NONE,
+    ICS_FREQ_DAILY,
+    ICS_FREQ_WEEKLY,
+    ICS_FREQ_MONTHLY,
+    ICS_FREQ_YEARLY
+} IcsFreq;
+
+/* Compact per-event record; only what decides which days are busy */
+typedef struct {
+    gint32  start;              /* First day, days since 1970-01-01 */
+    gint32  duration;           /* Days covered by each occurrence */
+    gint32  until;              /* Last day an occurrence may start */
+    guint32 count;              /* Occurrence limit, 0 for none or once resolved */
+    gint16  start_year;
+    guint8  start_month;
+    guint8  start_mday;
+    guint16 interval;
+    guint16 bymonth;            /* Month bits, bit 0 = January, 0 for none */
+    guint16 byday_nth[7];       /* ICS_NTH_* ordinals per weekday, Sunday first */
+    guint8  freq;
+    guint8  byday;              /* Weekday bits, bit 0 = Sunday */
+} IcsEvent;
+
+/* One indexed file */
+typedef struct {
+    AxisClockEvents *owner;
+    gchar           *path;
+    GFileMonitor    *monitor;   /* Only for files configured directly */
+    GArray          *recurring; /* IcsEvent with a recurrence rule */
+    GHashTable      *single;    /* month key -> day mask of one-off events */
+    GHashTable      *expanded;  /* month key -> day mask incl. recurrences */
+} IcsSource;
+
+struct _AxisClockEvents {
+    GHashTable                 *sources;        /* path -> IcsSource */
+    GList                      *dir_monitors;
+    AxisClockEventsChangedFunc  changed_func;
+    gpointer                    changed_data;
+};
+
+/* Property values collected while inside a VEVENT */
+typedef struct {
+    gboolean in_event;
+    gint     nested;            /* Depth of VALARM and friends */
+    gboolean has_start;
+    gboolean start_has_time;
+    gint32   start;
+    gint     start_seconds;
+    gboolean has_end;
+    gint32   end;               /* Exclusive */
+    gint64   duration_seconds;  /* -1 if unset */
+    gboolean cancelled;
+    gboolean has_nth;           /* BYDAY had an ordinal, even an unusable one */
+    IcsEvent rule;
+} IcsParser;
+
+/* A day of the expansion window, broken down once */
+typedef struct {
+    gint32 days;
+    gint   year;
+    gint   month;
+    gint   day;
+    gint   weekday;
+    gint   days_in_month;
+} IcsDay;
+
+static inline gpointer
+month_key(gint year, gint month)
+{
+    return GINT_TO_POINTER(year * 12 + month - 1);
+}
+
+/* Set the bits of [from, to) in the per-month masks of @table */
+static void
+mark_days(GHashTable *table, gint32 from, gint32 to)
+{
+    gint year, month, day;
+    
+    if (to <= from)
+        return;
+    
+    axisclock_date_from_days(from, &year, &month, &day);
+    
+    while (from < to) {
+        gint dim = axisclock_date_days_in_month(year, month);
+        gint last = MIN(dim, day + (to - from) - 1);
+        guint32 mask = GPOINTER_TO_UINT(g_hash_table_lookup(table, month_key(year, month)));
+        
+        for (gint d = day; d <= last; d++)
+            mask |= 1u << (d - 1);
+        g_hash_table_insert(table, month_key(year, month), GUINT_TO_POINTER(mask));
+        
+        from += last - day + 1;
+        day = 1;
+        if (++month > 12) {
+            month = 1;
+            year++;
+        }
+    }
+}
+
+/* Parse "YYYYMMDD[THHMMSS[Z]]"; UTC times are moved to the local day */
+static gboolean
+parse_date_time(const gchar *value, gint32 *days, gint *seconds, gboolean *has_time)
+{
+    gint year, month, day, hour = 0, minute = 0, second = 0;
+    
+    if (strlen(value) < 8)
+        return FALSE;
+    for (gint i = 0; i < 8; i++)
+        if (!g_ascii_isdigit(value[i]))
+            return FALSE;
+    
+    year = (value[0] - '0') * 1000 + (value[1] - '0') * 100 + (value[2] - '0') * 10 + (value[3] - '0');
+    month = (value[4] - '0') * 10 + (value[5] - '0');
+    day = (value[6] - '0') * 10 + (value[7] - '0');
+    if (month < 1 || month > 12 || day < 1 || day > 31)
+        return FALSE;
+    
+    *has_time = value[8] == 'T';
+    if (*has_time) {
+        /* The terminator stops this early on a short value */
+        for (gint i = 9; i < 15; i++)
+            if (!g_ascii_isdigit(value[i]))
+                return FALSE;
+        
+        hour = (value[9] - '0') * 10 + (value[10] - '0');
+        minute = (value[11] - '0') * 10 + (value[12] - '0');
+        second = (value[13] - '0') * 10 + (value[14] - '0');
+    }
+    
+    *days = axisclock_date_to_days(year, month, day);
+    *seconds = hour * 3600 + minute * 60 + second;
+    
+    if (*has_time && value[15] == 'Z') {
+        time_t utc = (time_t)*days * 86400 + *seconds;
+        struct tm local;
+        
+        localtime_r(&utc, &local);
+        *days = axisclock_date_to_days(local.tm_year + 1900, local.tm_mon + 1, local.tm_mday);
+        *seconds = local.tm_hour * 3600 + local.tm_min * 60 + local.tm_sec;
+    }
+    
+    return TRUE;
+}
+
+/* Parse an RFC 5545 duration such as "P1D", "PT1H30M" or "P2W" */
+static gint64
+parse_duration(const gchar *value)
+{
+    gint64 seconds = 0, number = 0;
+    gboolean negative = FALSE;
+    
+    if (*value == '-' || *value == '+')
+        negative = *value++ == '-';
+    if (*value++ != 'P')
+        return -1;
+    
+    for (; *value != '\0'; value++) {
+        if (g_ascii_isdigit(*value)) {
+            number = number * 10 + (*value - '0');
+            continue;
+        }
+        switch (*value) {
+            case 'W': seconds += number * 7 * 86400; break;
+            case 'D': seconds += number * 86400; break;
+            case 'H': seconds += number * 3600; break;
+            case 'M': seconds += number * 60; break;
+            case 'S': seconds += number; break;
+            default: break;
+        }
+        number = 0;
+    }
+    
+    return negative ? 0 : seconds;
+}
+
+static gint
+parse_weekday(const gchar *name)
+{
+    static const gchar *names[7] = { "SU", "MO", "TU", "WE", "TH", "FR", "SA" };
+    
+    for (gint i = 0; i < 7; i++)
+        if (g_ascii_strncasecmp(name, names[i], 2) == 0)
+            return i;
+    
+    return -1;
+}
+
+/* Parse the parts of an RRULE that affect which days are busy */
+static void
+parse_rrule(IcsParser *parser, const gchar *value)
+{
+    gchar **parts = g_strsplit(value, ";", -1);
+    
+    parser->rule.interval = 1;
+    parser->rule.until = G_MAXINT32;
+    
+    for (gchar **part = parts; *part != NULL; part++) {
+        const gchar *arg = strchr(*part, '=');
+        
+        if (arg == NULL)
+            continue;
+        arg++;
+        
+        if (g_str_has_prefix(*part, "FREQ=")) {
+            if (strcmp(arg, "DAILY") == 0)
+                parser->rule.freq = ICS_FREQ_DAILY;
+            else if (strcmp(arg, "WEEKLY") == 0)
+                parser->rule.freq = ICS_FREQ_WEEKLY;
+            else if (strcmp(arg, "MONTHLY") == 0)
+                parser->rule.freq = ICS_FREQ_MONTHLY;
+            else if (strcmp(arg, "YEARLY") == 0)
+                parser->rule.freq = ICS_FREQ_YEARLY;
+        } else if (g_str_has_prefix(*part, "INTERVAL=")) {
+            parser->rule.interval = CLAMP(g_ascii_strtoll(arg, NULL, 10), 1, G_MAXUINT16);
+        } else if (g_str_has_prefix(*part, "COUNT=")) {
+            parser->rule.count = (guint32)CLAMP(g_ascii_strtoll(arg, NULL, 10), 1, G_MAXINT32);
+        } else if (g_str_has_prefix(*part, "UNTIL=")) {
+            gint32 days;
+            gint seconds;
+            gboolean has_time;
+            
+            if (parse_date_time(arg, &days, &seconds, &has_time))
+                parser->rule.until = days;
+        } else if (g_str_has_prefix(*part, "BYDAY=")) {
+            gchar **days = g_strsplit(arg, ",", -1);
+            
+            for (gchar **day = days; *day != NULL; day++) {
+                const gchar *p = *day;
+                gint nth = 0, sign = 1, weekday;
+                
+                if (*p == '+' || *p == '-')
+                    sign = *p++ == '-' ? -1 : 1;
+                while (g_ascii_isdigit(*p))
+                    nth = nth * 10 + (*p++ - '0');
+                
+                weekday = parse_weekday(p);
+                if (weekday < 0)
+                    continue;
+                
+                parser->rule.byday |= 1u << weekday;
+                if (nth == 0) {
+                    parser->rule.byday_nth[weekday] |= ICS_NTH_EVERY;
+                } else {
+                    /* No month has a sixth weekday */
+                    if (nth <= 5)
+                        parser->rule.byday_nth[weekday] |= ICS_NTH_BIT(sign * nth);
+                    parser->has_nth = TRUE;
+                }
+            }
+            g_strfreev(days);
+        } else if (g_str_has_prefix(*part, "BYMONTH=")) {
+            gchar **months = g_strsplit(arg, ",", -1);
+            
+            for (gchar **month = months; *month != NULL; month++) {
+                gint64 value = g_ascii_strtoll(*month, NULL, 10);
+                
+                if (value >= 1 && value <= 12)
+                    parser->rule.bymonth |= 1u << (value - 1);
+            }
+            g_strfreev(months);
+        }
+    }
+    
+    g_strfreev(parts);
+}
+
+/* Break @days down into @day */
+static void
+ics_day_init(IcsDay *day, gint32 days)
+{
+    day->days = days;
+    axisclock_date_from_days(days, &day->year, &day->month, &day->day);
+    day->weekday = axisclock_date_weekday(days);
+    day->days_in_month = axisclock_date_days_in_month(day->year, day->month);
+}
+
+/* Whether @event recurs at all in the given month */
+static gboolean
+event_month_active(const IcsEvent *event, gint year, gint month)
+{
+    gint64 months = (year * 12 + month) - (event->start_year * 12 + event->start_month);
+    
+    if (event->bymonth != 0 && !(event->bymonth & (1u << (month - 1))))
+        return FALSE;
+    
+    switch (event->freq) {
+        case ICS_FREQ_MONTHLY:
+            return months % event->interval == 0;
+        
+        case ICS_FREQ_YEARLY:
+            if ((year - event->start_year) % event->interval != 0)
+                return FALSE;
+            /* Without BYMONTH only DTSTART's month, unless BYDAY spans the year */
+            return event->bymonth != 0 || event->byday != 0 || month == event->start_month;
+        
+        default:
+            return TRUE;
+    }
+}
+
+/* Whether @day is one of the BYDAY weekdays, counting ordinals in its month */
+static gboolean
+event_byday_matches(const IcsEvent *event, const IcsDay *day)
+{
+    guint ord = event->byday_nth[day->weekday];
+    gint nth = (day->day - 1) / 7 + 1;
+    gint last = (day->days_in_month - day->day) / 7 + 1;
+    
+    return (ord & (ICS_NTH_EVERY | ICS_NTH_BIT(nth) | ICS_NTH_BIT(-last))) != 0;
+}
+
+/* Whether an occurrence of @event starts on @day, ignoring COUNT */
+static gboolean
+event_starts_on(const IcsEvent *event, const IcsDay *day)
+{
+    if (day->days < event->start || day->days > event->until)
+        return FALSE;
+    
+    switch (event->freq) {
+        case ICS_FREQ_DAILY:
+            return (day->days - event->start) % event->interval == 0 &&
+                   (event->byday == 0 || (event->byday & (1u << day->weekday))) &&
+                   (event->bymonth == 0 || (event->bymonth & (1u << (day->month - 1))));
+        
+        case ICS_FREQ_WEEKLY: {
+            /* Weeks start on Monday (WKST default) */
+            gint64 start_week = (event->start - (axisclock_date_weekday(event->start) + 6) % 7) / 7;
+            gint64 day_week = (day->days - (day->weekday + 6) % 7) / 7;
+            
+            return (event->byday & (1u << day->weekday)) && (day_week - start_week) % event->interval == 0 &&
+                   (event->bymonth == 0 || (event->bymonth & (1u << (day->month - 1))));
+        }
+        
+        case ICS_FREQ_MONTHLY:
+        case ICS_FREQ_YEARLY:
+            if (!event_month_active(event, day->year, day->month))
+                return FALSE;
+            if (event->byday != 0)
+                return event_byday_matches(event, day);
+            return day->day == event->start_mday;
+        
+        default:
+            return FALSE;
+    }
+}
+
+/* Turn COUNT into the start day of the last counted occurrence, so that
+ * expanding a month only has to test the days in it. Months a rule skips
+ * are stepped over whole. */
+static void
+event_resolve_count(IcsEvent *event)
+{
+    gint32 last = MIN(event->until, event->start + ICS_COUNT_HORIZON_DAYS);
+    guint32 seen = 0;
+    IcsDay day;
+    
+    for (gint32 days = event->start; days <= last;) {
+        ics_day_init(&day, days);
+        
+        if ((event->freq == ICS_FREQ_MONTHLY || event->freq == ICS_FREQ_YEARLY) &&
+            !event_month_active(event, day.year, day.month)) {
+            days += day.days_in_month - day.day + 1;
+            continue;
+        }
+        
+        if (event_starts_on(event, &day) && ++seen == event->count) {
+            event->until = days;
+            break;
+        }
+        days += event->freq == ICS_FREQ_DAILY ? event->interval : 1;
+    }
+    
+    event->count = 0;
+}
+
+/* Turn the collected properties of one VEVENT into index entries */
+static void
+commit_event(IcsSource *source, IcsParser *parser)
+{
+    IcsEvent *event = &parser->rule;
+    gint32 end;
+    gint year, month, day;
+    
+    if (!parser->has_start || parser->cancelled)
+        return;
+    
+    if (parser->has_end) {
+        end = parser->end;
+    } else if (parser->duration_seconds >= 0) {
+        gint64 last = parser->start_seconds + MAX(parser->duration_seconds, 1) - 1;
+        end = parser->start + (gint32)(last / 86400) + 1;
+    } else {
+        end = parser->start + 1;
+    }
+    
+    event->start = parser->start;
+    event->duration = CLAMP(end - parser->start, 1, ICS_MAX_SPAN_DAYS);
+    
+    if (event->freq == ICS_FREQ_NONE) {
+        mark_days(source->single, event->start, event->start + event->duration);
+        return;
+    }
+    
+    axisclock_date_from_days(event->start, &year, &month, &day);
+    event->start_year = (gint16)year;
+    event->start_month = (guint8)month;
+    event->start_mday = (guint8)day;
+    event->duration = MIN(event->duration, ICS_MAX_RECURRING_SPAN);
+    if (event->freq == ICS_FREQ_WEEKLY && event->byday == 0)
+        event->byday = 1u << axisclock_date_weekday(event->start);
+    
+    /* Ordinals count within the month; "20MO" of a year is not supported */
+    if (event->freq == ICS_FREQ_YEARLY && event->bymonth == 0 && parser->has_nth)
+        return;
+    
+    if (event->count != 0)
+        event_resolve_count(event);
+    
+    g_array_append_val(source->recurring, *event);
+}
+
+/* Handle one unfolded content line */
+static void
+parse_line(IcsSource *source, IcsParser *parser, const gchar *line)
+{
+    const gchar *value;
+    gboolean quoted = FALSE;
+    gboolean date_only;
+    gint32 days;
+    gint seconds;
+    gboolean has_time;
+    
+    if (!parser->in_event) {
+        if (strcmp(line, "BEGIN:VEVENT") == 0) {
+            memset(parser, 0, sizeof(*parser));
+            parser->in_event = TRUE;
+            parser->duration_seconds = -1;
+        }
+        return;
+    }
+    
+    if (g_str_has_prefix(line, "BEGIN:")) {
+        parser->nested++;
+        return;
+    }
+    if (g_str_has_prefix(line, "END:")) {
+        if (parser->nested > 0) {
+            parser->nested--;
+        } else if (strcmp(line, "END:VEVENT") == 0) {
+            commit_event(source, parser);
+            parser->in_event = FALSE;
+        }
+        return;
+    }
+    if (parser->nested > 0)
+        return;
+    
+    /* The value starts after the first ':' outside quoted parameters */
+    for (value = line; *value != '\0'; value++) {
+        if (*value == '"')
+            quoted = !quoted;
+        else if (*value == ':' && !quoted)
+            break;
+    }
+    if (*value != ':')
+        return;
+    value++;
+    
+    date_only = strstr(line, "VALUE=DATE") != NULL && strstr(line, "VALUE=DATE-TIME") == NULL;
+    
+    if (g_str_has_prefix(line, "DTSTART")) {
+        if (parse_date_time(value, &days, &seconds, &has_time)) {
+            parser->has_start = TRUE;
+            parser->start = days;
+            parser->start_seconds = has_time && !date_only ? seconds : 0;
+            parser->start_has_time = has_time && !date_only;
+        }
+    } else if (g_str_has_prefix(line, "DTEND")) {
+        if (parse_date_time(value, &days, &seconds, &has_time)) {
+            parser->has_end = TRUE;
+            /* DATE ends are exclusive; a time past midnight busies that day */
+            parser->end = days + (has_time && !date_only && seconds > 0 ? 1 : 0);
+        }
+    } else if (g_str_has_prefix(line, "DURATION")) {
+        parser->duration_seconds = parse_duration(value);
+    } else if (g_str_has_prefix(line, "RRULE")) {
+        parse_rrule(parser, value);
+    } else if (g_str_has_prefix(line, "STATUS")) {
+        parser->cancelled = strcmp(value, "CANCELLED") == 0;
+    }
+}
+
+/* Stream over the mapped file, unfolding continuation lines */
+static void
+parse_buffer(IcsSource *source, const gchar *data, gsize length)
+{
+    const gchar *p = data;
+    const gchar *end = data + length;
+    GString *line = g_string_sized_new(128);
+    IcsParser parser;
+    
+    memset(&parser, 0, sizeof(parser));
+    
+    while (p < end) {
+        const gchar *eol = memchr(p, '\n', end - p);
+        const gchar *next;
+        gsize len;
+        
+        if (eol == NULL)
+            eol = end;
+        next = eol < end ? eol + 1 : end;
+        len = eol - p;
+        if (len > 0 && p[len - 1] == '\r')
+            len--;
+        
+        if (len > 0 && (*p == ' ' || *p == '\t')) {
+            g_string_append_len(line, p + 1, len - 1);
+        } else {
+            if (line->len > 0)
+                parse_line(source, &parser, line->str);
+            g_string_truncate(line, 0);
+            g_string_append_len(line, p, len);
+        }
+        
+        p = next;
+    }
+    
+    if (line->len > 0)
+        parse_line(source, &parser, line->str);
+    
+    g_string_free(line, TRUE);
+}
+
+/* (Re-)index one file */
+static void
+source_load(IcsSource *source)
+{
+    GMappedFile *mapped;
+    GError *error = NULL;
+    
+    g_array_set_size(source->recurring, 0);
+    g_hash_table_remove_all(source->single);
+    g_hash_table_remove_all(source->expanded);
+    
+    mapped = g_mapped_file_new(source->path, FALSE, &error);
+    if (mapped == NULL) {
+        g_debug("Cannot map '%s': %s", source->path, error->message);
+        g_error_free(error);
+        return;
+    }
+    
+    if (g_mapped_file_get_length(mapped) > 0)
+        parse_buffer(source, g_mapped_file_get_contents(mapped), g_mapped_file_get_length(mapped));
+    
+    g_mapped_file_unref(mapped);
+}
+
+static void
+events_notify_changed(AxisClockEvents *events)
+{
+    if (events->changed_func != NULL)
+        events->changed_func(events, events->changed_data);
+}
+
+/* A directly configured file changed on disk */
+static void
+source_file_changed_cb(GFileMonitor *monitor G_GNUC_UNUSED, GFile *file G_GNUC_UNUSED,
+                       GFile *other_file G_GNUC_UNUSED, GFileMonitorEvent event_type,
+                       gpointer user_data)
+{
+    IcsSource *source = user_data;
+    
+    switch (event_type) {
+        case G_FILE_MONITOR_EVENT_CHANGES_DONE_HINT:
+        case G_FILE_MONITOR_EVENT_CREATED:
+        case G_FILE_MONITOR_EVENT_DELETED:
+            source_load(source);
+            events_notify_changed(source->owner);
+            break;
+        default:
+            break;
+    }
+}
+
+static void
+source_free(gpointer data)
+{
+    IcsSource *source = data;
+    
+    if (source->monitor != NULL) {
+        g_signal_handlers_disconnect_by_data(source->monitor, source);
+        g_file_monitor_cancel(source->monitor);
+        g_object_unref(source->monitor);
+    }
+    g_array_free(source->recurring, TRUE);
+    g_hash_table_destroy(source->single);
+    g_hash_table_destroy(source->expanded);
+    g_free(source->path);
+    g_free(source);
+}
+
+static IcsSource *
+events_add_source(AxisClockEvents *events, const gchar *path, gboolean watch)
+{
+    IcsSource *source = g_new0(IcsSource, 1);
+    
+    source->owner = events;
+    source->path = g_strdup(path);
+    source->recurring = g_array_new(FALSE, FALSE, sizeof(IcsEvent));
+    source->single = g_hash_table_new(g_direct_hash, g_direct_equal);
+    source->expanded = g_hash_table_new(g_direct_hash, g_direct_equal);
+    g_hash_table_replace(events->sources, source->path, source);
+    
+    source_load(source);
+    
+    if (watch) {
+        GFile *file = g_file_new_for_path(path);
+        
+        source->monitor = g_file_monitor_file(file, G_FILE_MONITOR_NONE, NULL, NULL);
+        if (source->monitor != NULL)
+            g_signal_connect(source->monitor, "changed", G_CALLBACK(source_file_changed_cb), source);
+        g_object_unref(file);
+    }
+    
+    return source;
+}
+
+/* A file inside a watched directory appeared, changed or went away */
+static void
+directory_changed_cb(GFileMonitor *monitor G_GNUC_UNUSED, GFile *file,
+                     GFile *other_file G_GNUC_UNUSED, GFileMonitorEvent event_type,
+                     gpointer user_data)
+{
+    AxisClockEvents *events = user_data;
+    gchar *path = g_file_get_path(file);
+    IcsSource *source;
+    
+    if (path == NULL || !g_str_has_suffix(path, ".ics")) {
+        g_free(path);
+        return;
+    }
+    
+    source = g_hash_table_lookup(events->sources, path);
+    
+    switch (event_type) {
+        case G_FILE_MONITOR_EVENT_CHANGES_DONE_HINT:
+        case G_FILE_MONITOR_EVENT_CREATED:
+            if (source != NULL)
+                source_load(source);
+            else
+                events_add_source(events, path, FALSE);
+            events_notify_changed(events);
+            break;
+        case G_FILE_MONITOR_EVENT_DELETED:
+            if (source != NULL) {
+                g_hash_table_remove(events->sources, path);
+                events_notify_changed(events);
+            }
+            break;
+        default:
+            break;
+    }
+    
+    g_free(path);
+}
+
+static void
+events_add_directory(AxisClockEvents *events, const gchar *path)
+{
+    GFileMonitor *monitor;
+    const gchar *name;
+    GFile *file;
+    GDir *dir;
+    
+    dir = g_dir_open(path, 0, NULL);
+    if (dir == NULL)
+        return;
+    
+    while ((name = g_dir_read_name(dir)) != NULL) {
+        if (g_str_has_suffix(name, ".ics")) {
+            gchar *child = g_build_filename(path, name, NULL);
+            
+            events_add_source(events, child, FALSE);
+            g_free(child);
+        }
+    }
+    g_dir_close(dir);
+    
+    file = g_file_new_for_path(path);
+    monitor = g_file_monitor_directory(file, G_FILE_MONITOR_NONE, NULL, NULL);
+    if (monitor != NULL) {
+        g_signal_connect(monitor, "changed", G_CALLBACK(directory_changed_cb), events);
+        events->dir_monitors = g_list_prepend(events->dir_monitors, monitor);
+    }
+    g_object_unref(file);
+}
+
+/**
+ * axisclock_events_new:
+ * @paths: %NULL-terminated list of .ics files or directories holding them
+ *
+ * Indexes @paths and starts watching them. A leading "~/" is expanded.
+ *
+ * Returns: A new #AxisClockEvents.
+ */
+AxisClockEvents *
+axisclock_events_new(const gchar * const *paths)
+{
+    AxisClockEvents *events = g_new0(AxisClockEvents, 1);
+    
+    events->sources = g_hash_table_new_full(g_str_hash, g_str_equal, NULL, source_free);
+    
+    for (; paths != NULL && *paths != NULL; paths++) {
+        gchar *path = g_str_has_prefix(*paths, "~/")
+                      ? g_build_filename(g_get_home_dir(), *paths + 2, NULL)
+                      : g_strdup(*paths);
+        
+        if (g_file_test(path, G_FILE_TEST_IS_DIR))
+            events_add_directory(events, path);
+        else
+            events_add_source(events, path, TRUE);
+        
+        g_free(path);
+    }
+    
+    return events;
+}
+
+/**
+ * axisclock_events_free:
+ * @events: A #AxisClockEvents
+ *
+ * Stops watching and frees the index.
+ */
+void
+axisclock_events_free(AxisClockEvents *events)
+{
+    if (events == NULL)
+        return;
+    
+    for (GList *l = events->dir_monitors; l != NULL; l = l->next) {
+        g_signal_handlers_disconnect_by_data(l->data, events);
+        g_file_monitor_cancel(l->data);
+        g_object_unref(l->data);
+    }
+    g_list_free(events->dir_monitors);
+    g_hash_table_destroy(events->sources);
+    g_free(events);
+}
+
+/**
+ * axisclock_events_set_changed_callback:
+ * @events: A #AxisClockEvents
+ * @func: Called after a watched file was re-indexed
+ * @user_data: Passed to @func
+ */
+void
+axisclock_events_set_changed_callback(AxisClockEvents *events,
+                                      AxisClockEventsChangedFunc func,
+                                      gpointer user_data)
+{
+    g_return_if_fail(events != NULL);
+    
+    events->changed_func = func;
+    events->changed_data = user_data;
+}
+
+/* Day mask of one month for one file, expanding recurrences on first use */
+static guint32
+source_get_month_mask(IcsSource *source, gint year, gint month)
+{
+    IcsDay window[31 + ICS_MAX_RECURRING_SPAN];
+    gpointer cached;
+    guint32 mask;
+    gint32 month_start, month_end;
+    gint n_days, dim;
+    
+    if (g_hash_table_lookup_extended(source->expanded, month_key(year, month), NULL, &cached))
+        return GPOINTER_TO_UINT(cached);
+    
+    mask = GPOINTER_TO_UINT(g_hash_table_lookup(source->single, month_key(year, month)));
+    
+    if (source->recurring->len > 0) {
+        dim = axisclock_date_days_in_month(year, month);
+        month_start = axisclock_date_to_days(year, month, 1);
+        month_end = month_start + dim;
+        
+        /* Occurrences starting up to a span before the month can reach into it */
+        n_days = dim + ICS_MAX_RECURRING_SPAN - 1;
+        for (gint i = 0; i < n_days; i++)
+            ics_day_init(&window[i], month_start - (ICS_MAX_RECURRING_SPAN - 1) + i);
+        
+        for (guint e = 0; e < source->recurring->len; e++) {
+            const IcsEvent *event = &g_array_index(source->recurring, IcsEvent, e);
+            
+            if (event->start >= month_end || event->until < window[0].days)
+                continue;
+            
+            for (gint i = 0; i < n_days; i++) {
+                const IcsDay *day = &window[i];
+                
+                if (day->days + event->duration <= month_start || !event_starts_on(event, day))
+                    continue;
+                
+                for (gint32 d = MAX(day->days, month_start); d < MIN(day->days + event->duration, month_end); d++)
+                    mask |= 1u << (d - month_start);
+            }
+        }
+    }
+    
+    g_hash_table_insert(source->expanded, month_key(year, month), GUINT_TO_POINTER(mask));
+    return mask;
+}
+
+/**
+ * axisclock_events_get_month_mask:
+ * @events: A #AxisClockEvents
+ * @year: Year
+ * @month: Month, 1-12
+ *
+ * Returns: Bit (day - 1) is set for every day of the month with an event.
+ */
+guint32
+axisclock_events_get_month_mask(AxisClockEvents *events, gint year, gint month)
+{
+    GHashTableIter iter;
+    gpointer source;
+    guint32 mask = 0;
+    
+    g_return_val_if_fail(events != NULL, 0);
+    
+    g_hash_table_iter_init(&iter, events->sources);
+    while (g_hash_table_iter_next(&iter, NULL, &source))
+        mask |= source_get_month_mask(source, year, month);
+    
+    return mask;
+}
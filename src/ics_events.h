@@ -0,0 +1,55 @@
+/*
+ * xfce4-axisclock-plugin - A macOS-style clock plugin for the Xfce panel
+ *
+ * Copyright (c) 2025 Kamil 'Novik' Nowicki <novik@axisos.org>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Website: https://axisos.org
+ * Repository: https://github.com/AxisOS/xfce4-axisclock-plugin
+ */
+
+#ifndef __ICS_EVENTS_H__
+#define __ICS_EVENTS_H__
+
+#include <glib.h>
+
+G_BEGIN_DECLS
+
+typedef struct _AxisClockEvents AxisClockEvents;
+
+/* Called after a watched file was re-indexed */
+typedef void (*AxisClockEventsChangedFunc) (AxisClockEvents *events,
+                                            gpointer         user_data);
+
+/*
+ * Day-level overlay of local iCalendar files. Files are read through a
+ * read-only mapping and scanned line by line; only the VEVENT properties
+ * that decide which days are busy are kept. One-off events go straight into
+ * a per-month day mask, recurring events are expanded lazily for the months
+ * actually viewed. Files are watched and re-indexed one at a time.
+ */
+AxisClockEvents *axisclock_events_new                  (const gchar * const        *paths);
+void             axisclock_events_free                 (AxisClockEvents            *events);
+void             axisclock_events_set_changed_callback (AxisClockEvents            *events,
+                                                        AxisClockEventsChangedFunc  func,
+                                                        gpointer                    user_data);
+guint32          axisclock_events_get_month_mask       (AxisClockEvents            *events,
+                                                        gint                        year,
+                                                        gint                        month);
+
+G_END_DECLS
+
+#endif /* !__ICS_EVENTS_H__ */
@@ -0,0 +1,241 @@
+/*
+ * xfce4-axisclock-plugin - A macOS-style clock plugin for the Xfce panel
+ *
+ * Copyright (c) 2025 Kamil 'Novik' Nowicki <novik@axisos.org>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Website: https://axisos.org
+ * Repository: https://github.com/AxisOS/xfce4-axisclock-plugin
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <gtk/gtk.h>
+
+#include "invalidator.h"
+#include "profiler.h"
+
+/* Fallback when no watched widget is mapped: just ahead of the redraw */
+#define INVALIDATOR_IDLE_PRIORITY (GDK_PRIORITY_REDRAW - 10)
+
+/* A cache rebuilt after style changes */
+typedef struct {
+    AxisClockRebuildFunc func;
+    gpointer             user_data;
+} RebuildClient;
+
+struct _AxisClockInvalidator {
+    GPtrArray *widgets;             /* GtkWidget, not referenced */
+    GArray    *clients;             /* RebuildClient, in registration order */
+    
+    /* Pending rebuild: a tick callback on @tick_widget or an idle source */
+    GtkWidget *tick_widget;
+    guint      tick_id;
+    guint      idle_id;
+};
+
+/* Run every rebuild once for all notifications since the last one */
+static void
+invalidator_rebuild(AxisClockInvalidator *invalidator)
+{
+    AXISCLOCK_COUNT(AXISCLOCK_COUNTER_STYLE_REBUILDS);
+    
+    for (guint i = 0; i < invalidator->clients->len; i++) {
+        const RebuildClient *client = &g_array_index(invalidator->clients, RebuildClient, i);
+        
+        client->func(client->user_data);
+    }
+}
+
+static gboolean
+invalidator_tick_cb(GtkWidget *widget G_GNUC_UNUSED, GdkFrameClock *clock G_GNUC_UNUSED, gpointer data)
+{
+    AxisClockInvalidator *invalidator = (AxisClockInvalidator *)data;
+    
+    invalidator->tick_widget = NULL;
+    invalidator->tick_id = 0;
+    invalidator_rebuild(invalidator);
+    
+    return G_SOURCE_REMOVE;
+}
+
+static gboolean
+invalidator_idle_cb(gpointer data)
+{
+    AxisClockInvalidator *invalidator = (AxisClockInvalidator *)data;
+    
+    invalidator->idle_id = 0;
+    invalidator_rebuild(invalidator);
+    
+    return G_SOURCE_REMOVE;
+}
+
+/* Put the pending rebuild on the frame clock of @hint or another mapped
+ * widget than @exclude; hidden windows have no running clock, so fall back
+ * to an idle */
+static void
+invalidator_start(AxisClockInvalidator *invalidator, GtkWidget *hint, GtkWidget *exclude)
+{
+    GtkWidget *widget = NULL;
+    
+    if (hint != NULL && hint != exclude && gtk_widget_get_mapped(hint)) {
+        widget = hint;
+    } else {
+        for (guint i = 0; i < invalidator->widgets->len && widget == NULL; i++) {
+            GtkWidget *candidate = g_ptr_array_index(invalidator->widgets, i);
+            
+            if (candidate != exclude && gtk_widget_get_mapped(candidate))
+                widget = candidate;
+        }
+    }
+    
+    if (widget != NULL) {
+        invalidator->tick_widget = widget;
+        invalidator->tick_id = gtk_widget_add_tick_callback(widget, invalidator_tick_cb, invalidator, NULL);
+    } else {
+        invalidator->idle_id = g_idle_add_full(INVALIDATOR_IDLE_PRIORITY, invalidator_idle_cb, invalidator, NULL);
+    }
+}
+
+/* Schedule one rebuild for a burst of notifications */
+static void
+invalidator_schedule(AxisClockInvalidator *invalidator, GtkWidget *hint)
+{
+    AXISCLOCK_COUNT(AXISCLOCK_COUNTER_STYLE_NOTIFICATIONS);
+    
+    if (invalidator->tick_id != 0 || invalidator->idle_id != 0)
+        return;
+    
+    invalidator_start(invalidator, hint, NULL);
+}
+
+/* The widget carrying the pending rebuild was hidden before its next
+ * frame, e.g. the label on a switch to glyphs or the popup on close. Its
+ * tick callback would wait for the next map, so move the rebuild */
+static void
+invalidator_unmap_cb(GtkWidget *widget, gpointer data)
+{
+    AxisClockInvalidator *invalidator = (AxisClockInvalidator *)data;
+    
+    if (invalidator->tick_id == 0 || invalidator->tick_widget != widget)
+        return;
+    
+    gtk_widget_remove_tick_callback(widget, invalidator->tick_id);
+    invalidator->tick_widget = NULL;
+    invalidator->tick_id = 0;
+    invalidator_start(invalidator, NULL, widget);
+}
+
+/* Font or theme changed */
+static void
+invalidator_style_updated_cb(GtkWidget *widget, gpointer data)
+{
+    invalidator_schedule((AxisClockInvalidator *)data, widget);
+}
+
+/* Moved to another screen, with its own settings and font options */
+static void
+invalidator_screen_changed_cb(GtkWidget *widget, GdkScreen *previous G_GNUC_UNUSED, gpointer data)
+{
+    invalidator_schedule((AxisClockInvalidator *)data, widget);
+}
+
+/* Moved to a monitor with another scale factor */
+static void
+invalidator_scale_factor_cb(GObject *object, GParamSpec *pspec G_GNUC_UNUSED, gpointer data)
+{
+    invalidator_schedule((AxisClockInvalidator *)data, GTK_WIDGET(object));
+}
+
+/**
+ * axisclock_invalidator_new:
+ *
+ * Returns: A new #AxisClockInvalidator without widgets or clients.
+ */
+AxisClockInvalidator *
+axisclock_invalidator_new(void)
+{
+    AxisClockInvalidator *invalidator = g_new0(AxisClockInvalidator, 1);
+    
+    invalidator->widgets = g_ptr_array_new();
+    invalidator->clients = g_array_new(FALSE, FALSE, sizeof(RebuildClient));
+    
+    return invalidator;
+}
+
+/**
+ * axisclock_invalidator_free:
+ * @invalidator: A #AxisClockInvalidator
+ *
+ * Disconnects from the watched widgets and drops a pending rebuild.
+ */
+void
+axisclock_invalidator_free(AxisClockInvalidator *invalidator)
+{
+    if (invalidator == NULL)
+        return;
+    
+    if (invalidator->tick_id != 0)
+        gtk_widget_remove_tick_callback(invalidator->tick_widget, invalidator->tick_id);
+    if (invalidator->idle_id != 0)
+        g_source_remove(invalidator->idle_id);
+    
+    for (guint i = 0; i < invalidator->widgets->len; i++)
+        g_signal_handlers_disconnect_by_data(g_ptr_array_index(invalidator->widgets, i), invalidator);
+    
+    g_ptr_array_free(invalidator->widgets, TRUE);
+    g_array_free(invalidator->clients, TRUE);
+    g_free(invalidator);
+}
+
+/**
+ * axisclock_invalidator_watch:
+ * @invalidator: A #AxisClockInvalidator
+ * @widget: Widget whose style, screen and scale factor are followed
+ */
+void
+axisclock_invalidator_watch(AxisClockInvalidator *invalidator, GtkWidget *widget)
+{
+    g_return_if_fail(invalidator != NULL);
+    g_return_if_fail(GTK_IS_WIDGET(widget));
+    
+    g_ptr_array_add(invalidator->widgets, widget);
+    g_signal_connect(widget, "style-updated", G_CALLBACK(invalidator_style_updated_cb), invalidator);
+    g_signal_connect(widget, "screen-changed", G_CALLBACK(invalidator_screen_changed_cb), invalidator);
+    g_signal_connect(widget, "notify::scale-factor", G_CALLBACK(invalidator_scale_factor_cb), invalidator);
+    g_signal_connect(widget, "unmap", G_CALLBACK(invalidator_unmap_cb), invalidator);
+}
+
+/**
+ * axisclock_invalidator_add_client:
+ * @invalidator: A #AxisClockInvalidator
+ * @func: Rebuilds one cache of colors, metrics, surfaces or layouts
+ * @user_data: Data for @func
+ *
+ * Clients run in the order they were added, once per coalesced burst.
+ */
+void
+axisclock_invalidator_add_client(AxisClockInvalidator *invalidator, AxisClockRebuildFunc func, gpointer user_data)
+{
+    RebuildClient client = { func, user_data };
+    
+    g_return_if_fail(invalidator != NULL);
+    g_return_if_fail(func != NULL);
+    
+    g_array_append_val(invalidator->clients, client);
+}
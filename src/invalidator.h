@@ -0,0 +1,53 @@
+/*
+ * xfce4-axisclock-plugin - A macOS-style clock plugin for the Xfce panel
+ *
+ * Copyright (c) 2025 Kamil 'Novik' Nowicki <novik@axisos.org>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Website: https://axisos.org
+ * Repository: https://github.com/AxisOS/xfce4-axisclock-plugin
+ */
+
+#ifndef __INVALIDATOR_H__
+#define __INVALIDATOR_H__
+
+#include <gtk/gtk.h>
+
+G_BEGIN_DECLS
+
+typedef struct _AxisClockInvalidator AxisClockInvalidator;
+
+typedef void (*AxisClockRebuildFunc) (gpointer user_data);
+
+/*
+ * One per plugin. Theme switches, DPI changes and moves between monitors
+ * arrive as bursts of style-updated, screen-changed and scale-factor
+ * notifications on several widgets; the invalidator only marks itself
+ * dirty for each of them and runs every registered rebuild once, from the
+ * next frame clock update, before that frame is laid out and painted.
+ * Watched widgets must outlive the invalidator.
+ */
+AxisClockInvalidator *axisclock_invalidator_new        (void);
+void                  axisclock_invalidator_free       (AxisClockInvalidator *invalidator);
+void                  axisclock_invalidator_watch      (AxisClockInvalidator *invalidator,
+                                                        GtkWidget            *widget);
+void                  axisclock_invalidator_add_client (AxisClockInvalidator *invalidator,
+                                                        AxisClockRebuildFunc  func,
+                                                        gpointer              user_data);
+
+G_END_DECLS
+
+#endif /* !__INVALIDATOR_H__ */
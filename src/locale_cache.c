@@ -0,0 +1,357 @@
+/*
+ * xfce4-axisclock-plugin - A macOS-style clock plugin for the Xfce panel
+ *
+ * Copyright (c) 2025 Kamil 'Novik' Nowicki <novik@axisos.org>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Website: https://axisos.org
+ * Repository: https://github.com/AxisOS/xfce4-axisclock-plugin
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <glib.h>
+#include <langinfo.h>
+#include <locale.h>
+#include <string.h>
+
+#include "data_cache.h"
+#include "locale_cache.h"
+
+/* Strings of a snapshot, in the order of locale_list_strings() */
+#define LOCALE_N_STRINGS (7 * 3 + 12 * 3 + 2)
+
+/* Shared cache entry of one snapshot: this header, then the strings, each
+ * NUL-terminated */
+typedef struct {
+    gint32  first_weekday;
+    guint32 strings[LOCALE_N_STRINGS][2];   /* Offset from the entry start, length */
+} LocaleEntry;
+
+static AxisClockLocale *snapshot = NULL;
+static guint snapshot_serial = 0;
+
+/* Cache entry the snapshot's strings point into, NULL if they are owned */
+static GBytes *snapshot_data = NULL;
+
+/* Store @text, converted from the locale codeset, in @out */
+static void
+locale_string_set(AxisClockLocaleString *out, const gchar *text, const gchar *fallback)
+{
+    gchar *utf8 = NULL;
+    gsize length = 0;
+    
+    if (text != NULL)
+        utf8 = g_locale_to_utf8(text, -1, NULL, &length, NULL);
+    
+    if (utf8 == NULL) {
+        utf8 = g_strdup(fallback);
+        length = strlen(utf8);
+    }
+    
+    out->text = utf8;
+    out->length = length;
+}
+
+/* Store the lowercase form of @text in @out */
+static void
+locale_string_set_lower(AxisClockLocaleString *out, const gchar *text, const gchar *fallback)
+{
+    AxisClockLocaleString source;
+    
+    locale_string_set(&source, text, fallback);
+    out->text = g_utf8_strdown(source.text, source.length);
+    out->length = strlen(out->text);
+    g_free(source.text);
+}
+
+/* Store the first character of @source in @out */
+static void
+locale_string_set_initial(AxisClockLocaleString *out, const AxisClockLocaleString *source)
+{
+    const gchar *end = source->length > 0 ? g_utf8_next_char(source->text) : source->text;
+    
+    out->length = end - source->text;
+    out->text = g_strndup(source->text, out->length);
+}
+
+static void
+locale_string_clear(AxisClockLocaleString *string)
+{
+    g_free(string->text);
+    string->text = NULL;
+    string->length = 0;
+}
+
+/* First day of the week from the locale, 0 = Sunday */
+static gint
+locale_get_first_weekday(void)
+{
+#ifdef HAVE__NL_TIME_FIRST_WEEKDAY
+    union { unsigned int word; char *string; } langinfo;
+    gint week_1stday = 0;
+    gint first_weekday;
+    guint week_origin;
+    
+    /* Same computation as GtkCalendar: the week origin date tells which
+     * weekday _NL_TIME_FIRST_WEEKDAY counts from */
+    langinfo.string = nl_langinfo(_NL_TIME_FIRST_WEEKDAY);
+    first_weekday = langinfo.string[0];
+    langinfo.string = nl_langinfo(_NL_TIME_WEEK_1STDAY);
+    week_origin = langinfo.word;
+    
+    if (week_origin == 19971130)        /* Sunday */
+        week_1stday = 0;
+    else if (week_origin == 19971201)   /* Monday */
+        week_1stday = 1;
+    else
+        g_warning("Unknown value of _NL_TIME_WEEK_1STDAY");
+    
+    return (week_1stday + first_weekday - 1 + 7) % 7;
+#else
+    return 0;
+#endif
+}
+
+/* Every string of @locale in a fixed order */
+static void
+locale_list_strings(AxisClockLocale *locale, AxisClockLocaleString **strings)
+{
+    guint n = 0;
+    
+    for (guint i = 0; i < 7; i++) {
+        strings[n++] = &locale->abday[i];
+        strings[n++] = &locale->day[i];
+        strings[n++] = &locale->day_initial[i];
+    }
+    for (guint i = 0; i < 12; i++) {
+        strings[n++] = &locale->abmon[i];
+        strings[n++] = &locale->mon[i];
+        strings[n++] = &locale->mon_standalone[i];
+    }
+    strings[n++] = &locale->am;
+    strings[n++] = &locale->pm;
+}
+
+static void
+locale_free(AxisClockLocale *locale)
+{
+    AxisClockLocaleString *strings[LOCALE_N_STRINGS];
+    
+    /* Strings taken from the shared cache go with the mapping */
+    if (snapshot_data != NULL) {
+        g_clear_pointer(&snapshot_data, g_bytes_unref);
+    } else {
+        locale_list_strings(locale, strings);
+        for (guint i = 0; i < LOCALE_N_STRINGS; i++)
+            locale_string_clear(strings[i]);
+    }
+    g_free(locale->name);
+    g_free(locale);
+}
+
+static AxisClockLocale *
+locale_build(const gchar *name)
+{
+    static const nl_item abday_items[7] = { ABDAY_1, ABDAY_2, ABDAY_3, ABDAY_4, ABDAY_5, ABDAY_6, ABDAY_7 };
+    static const nl_item day_items[7] = { DAY_1, DAY_2, DAY_3, DAY_4, DAY_5, DAY_6, DAY_7 };
+    static const nl_item abmon_items[12] = { ABMON_1, ABMON_2, ABMON_3, ABMON_4, ABMON_5, ABMON_6,
+                                             ABMON_7, ABMON_8, ABMON_9, ABMON_10, ABMON_11, ABMON_12 };
+    static const nl_item mon_items[12] = { MON_1, MON_2, MON_3, MON_4, MON_5, MON_6,
+                                           MON_7, MON_8, MON_9, MON_10, MON_11, MON_12 };
+#ifdef ALTMON_1
+    static const nl_item altmon_items[12] = { ALTMON_1, ALTMON_2, ALTMON_3, ALTMON_4, ALTMON_5, ALTMON_6,
+                                              ALTMON_7, ALTMON_8, ALTMON_9, ALTMON_10, ALTMON_11, ALTMON_12 };
+#endif
+    static const gchar *c_abday[7] = { "Sun", "Mon", "Tue", "Wed", "Thu", "Fri", "Sat" };
+    static const gchar *c_abmon[12] = { "Jan", "Feb", "Mar", "Apr", "May", "Jun",
+                                        "Jul", "Aug", "Sep", "Oct", "Nov", "Dec" };
+    AxisClockLocale *locale = g_new0(AxisClockLocale, 1);
+    
+    locale->name = g_strdup(name);
+    locale->serial = ++snapshot_serial;
+    
+    for (guint i = 0; i < 7; i++) {
+        locale_string_set(&locale->abday[i], nl_langinfo(abday_items[i]), c_abday[i]);
+        locale_string_set(&locale->day[i], nl_langinfo(day_items[i]), c_abday[i]);
+        locale_string_set_initial(&locale->day_initial[i], &locale->abday[i]);
+    }
+    
+    for (guint i = 0; i < 12; i++) {
+        locale_string_set(&locale->abmon[i], nl_langinfo(abmon_items[i]), c_abmon[i]);
+        locale_string_set(&locale->mon[i], nl_langinfo(mon_items[i]), c_abmon[i]);
+#ifdef ALTMON_1
+        locale_string_set(&locale->mon_standalone[i], nl_langinfo(altmon_items[i]), locale->mon[i].text);
+#else
+        locale_string_set(&locale->mon_standalone[i], nl_langinfo(mon_items[i]), c_abmon[i]);
+#endif
+    }
+    
+    locale_string_set_lower(&locale->am, nl_langinfo(AM_STR), "");
+    locale_string_set_lower(&locale->pm, nl_langinfo(PM_STR), "");
+    
+    locale->first_weekday = locale_get_first_weekday();
+    
+    return locale;
+}
+
+/* Snapshot built from the cache entry in @bytes, NULL if it is malformed */
+static AxisClockLocale *
+locale_load(const gchar *name, GBytes *bytes)
+{
+    gsize size;
+    const gchar *data = g_bytes_get_data(bytes, &size);
+    const LocaleEntry *entry = (const LocaleEntry *)data;
+    AxisClockLocaleString *strings[LOCALE_N_STRINGS];
+    AxisClockLocale *locale;
+    
+    if (size < sizeof(LocaleEntry))
+        return NULL;
+    
+    for (guint i = 0; i < LOCALE_N_STRINGS; i++) {
+        guint32 offset = entry->strings[i][0];
+        guint32 length = entry->strings[i][1];
+        
+        if (offset > size || length >= size - offset || data[offset + length] != '\0')
+            return NULL;
+    }
+    
+    locale = g_new0(AxisClockLocale, 1);
+    locale->name = g_strdup(name);
+    locale->serial = ++snapshot_serial;
+    locale->first_weekday = CLAMP(entry->first_weekday, 0, 6);
+    
+    locale_list_strings(locale, strings);
+    for (guint i = 0; i < LOCALE_N_STRINGS; i++) {
+        strings[i]->text = (gchar *)data + entry->strings[i][0];
+        strings[i]->length = entry->strings[i][1];
+    }
+    
+    return locale;
+}
+
+/* Serialize @locale for the shared cache */
+static gpointer
+locale_save(AxisClockLocale *locale, gsize *size)
+{
+    AxisClockLocaleString *strings[LOCALE_N_STRINGS];
+    LocaleEntry *entry;
+    gsize offset = sizeof(LocaleEntry);
+    
+    locale_list_strings(locale, strings);
+    for (guint i = 0; i < LOCALE_N_STRINGS; i++)
+        offset += strings[i]->length + 1;
+    
+    entry = g_malloc0(offset);
+    entry->first_weekday = locale->first_weekday;
+    *size = offset;
+    
+    offset = sizeof(LocaleEntry);
+    for (guint i = 0; i < LOCALE_N_STRINGS; i++) {
+        entry->strings[i][0] = offset;
+        entry->strings[i][1] = strings[i]->length;
+        memcpy((gchar *)entry + offset, strings[i]->text, strings[i]->length);
+        offset += strings[i]->length + 1;
+    }
+    
+    return entry;
+}
+
+/* Snapshot for @name from the shared cache; built and shared on a miss.
+ * The stamp covers the compiled locale data, the entry name the charset
+ * the strings were converted from */
+static AxisClockLocale *
+locale_get_shared(const gchar *name)
+{
+    const gchar *charset;
+    const gchar *locpath = g_getenv("LOCPATH");
+    gchar *lc_time;
+    gchar *key;
+    const gchar *paths[3];
+    guint64 stamp;
+    GBytes *bytes;
+    AxisClockLocale *locale = NULL;
+    
+    g_get_charset(&charset);
+    lc_time = g_build_filename(locpath != NULL && *locpath != '\0' ? locpath : "/usr/lib/locale",
+                               name, "LC_TIME", NULL);
+    paths[0] = "/usr/lib/locale/locale-archive";
+    paths[1] = lc_time;
+    paths[2] = NULL;
+    stamp = axisclock_data_cache_stamp(paths, locpath);
+    key = g_strdup_printf("locale/%s/%s", name, charset);
+    
+    bytes = axisclock_data_cache_lookup(key, stamp);
+    if (bytes != NULL) {
+        locale = locale_load(name, bytes);
+        if (locale != NULL)
+            snapshot_data = bytes;
+        else
+            g_bytes_unref(bytes);
+    }
+    
+    if (locale == NULL) {
+        gpointer data;
+        gsize size;
+        
+        locale = locale_build(name);
+        data = locale_save(locale, &size);
+        axisclock_data_cache_store(key, stamp, data, size);
+        g_free(data);
+    }
+    
+    g_free(key);
+    g_free(lc_time);
+    return locale;
+}
+
+/**
+ * axisclock_locale_get:
+ *
+ * Returns the locale snapshot, building it on first use and rebuilding it
+ * when the LC_TIME locale changed since. Snapshots another instance
+ * already built are taken from the shared data cache.
+ *
+ * Returns: The snapshot, owned by the cache. Compare @serial to notice
+ * rebuilds.
+ */
+const AxisClockLocale *
+axisclock_locale_get(void)
+{
+    const gchar *name = setlocale(LC_TIME, NULL);
+    
+    if (snapshot != NULL && g_strcmp0(snapshot->name, name) == 0)
+        return snapshot;
+    
+    if (snapshot != NULL)
+        locale_free(snapshot);
+    snapshot = locale_get_shared(name);
+    
+    return snapshot;
+}
+
+/**
+ * axisclock_locale_invalidate:
+ *
+ * Drops the snapshot so the next axisclock_locale_get() rebuilds it.
+ */
+void
+axisclock_locale_invalidate(void)
+{
+    g_clear_pointer(&snapshot, locale_free);
+}
@@ -0,0 +1,74 @@
+/*
+ * xfce4-axisclock-plugin - A macOS-style clock plugin for the Xfce panel
+ *
+ * Copyright (c) 2025 Kamil 'Novik' Nowicki <novik@axisos.org>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Website: https://axisos.org
+ * Repository: https://github.com/AxisOS/xfce4-axisclock-plugin
+ */
+
+#ifndef __LOCALE_CACHE_H__
+#define __LOCALE_CACHE_H__
+
+#include <glib.h>
+
+G_BEGIN_DECLS
+
+/* A UTF-8 string together with its length in bytes */
+typedef struct _AxisClockLocaleString {
+    gchar *text;
+    gsize  length;
+} AxisClockLocaleString;
+
+/**
+ * AxisClockLocale:
+ * @name: LC_TIME locale the snapshot was built for
+ * @serial: Changes every time the snapshot is rebuilt
+ * @abday: Abbreviated weekday names, Sunday first
+ * @day: Full weekday names, Sunday first
+ * @day_initial: First character of each abbreviated weekday name
+ * @abmon: Abbreviated month names
+ * @mon: Full month names as used inside a date
+ * @mon_standalone: Full month names for headings
+ * @am: Lowercase AM marker, possibly empty
+ * @pm: Lowercase PM marker, possibly empty
+ * @first_weekday: First day of the week, 0 = Sunday
+ *
+ * Locale strings needed by the formatter and the calendar, converted to
+ * UTF-8 and measured once instead of on every tick.
+ */
+typedef struct _AxisClockLocale {
+    gchar                 *name;
+    guint                  serial;
+    AxisClockLocaleString  abday[7];
+    AxisClockLocaleString  day[7];
+    AxisClockLocaleString  day_initial[7];
+    AxisClockLocaleString  abmon[12];
+    AxisClockLocaleString  mon[12];
+    AxisClockLocaleString  mon_standalone[12];
+    AxisClockLocaleString  am;
+    AxisClockLocaleString  pm;
+    gint                   first_weekday;
+} AxisClockLocale;
+
+/* Function prototypes */
+const AxisClockLocale *axisclock_locale_get        (void);
+void                   axisclock_locale_invalidate (void);
+
+G_END_DECLS
+
+#endif /* !__LOCALE_CACHE_H__ */
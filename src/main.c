@@ -59,6 +59,60 @@ axisclock_show_about(XfcePanelPlugin *plugin G_GNUC_UNUSED)
                           NULL);
 }
 
+/* Start the countdown with the configured length */
+static void
+axisclock_start_timer(GtkMenuItem *item G_GNUC_UNUSED, AxisClockPlugin *axisclock)
+{
+    axisclock_alarms_start_countdown(axisclock->alarms, axisclock->config->timer_minutes * 60);
+}
+
+/* Cancel a running countdown */
+static void
+axisclock_cancel_timer(GtkMenuItem *item G_GNUC_UNUSED, AxisClockPlugin *axisclock)
+{
+    axisclock_alarms_cancel_countdown(axisclock->alarms);
+}
+
+/* Start or pause the stopwatch */
+static void
+axisclock_toggle_stopwatch(GtkMenuItem *item G_GNUC_UNUSED, AxisClockPlugin *axisclock)
+{
+    axisclock_alarms_toggle_stopwatch(axisclock->alarms);
+}
+
+/* Stop and clear the stopwatch */
+static void
+axisclock_reset_stopwatch(GtkMenuItem *item G_GNUC_UNUSED, AxisClockPlugin *axisclock)
+{
+    axisclock_alarms_reset_stopwatch(axisclock->alarms);
+}
+
+/* Panel orientation changed */
+static void
+axisclock_mode_changed(XfcePanelPlugin *plugin G_GNUC_UNUSED, XfcePanelPluginMode mode, AxisClockPlugin *axisclock)
+{
+    axisclock_set_mode(axisclock, mode);
+}
+
+/* Panel thickness changed */
+static gboolean
+axisclock_size_changed(XfcePanelPlugin *plugin G_GNUC_UNUSED, gint size, AxisClockPlugin *axisclock)
+{
+    axisclock_set_size(axisclock, size);
+    return TRUE;
+}
+
+/* Add an item to the panel's right-click menu */
+static void
+axisclock_menu_add(XfcePanelPlugin *plugin, const gchar *label, GCallback callback, AxisClockPlugin *axisclock)
+{
+    GtkWidget *item = gtk_menu_item_new_with_mnemonic(label);
+    
+    g_signal_connect(item, "activate", callback, axisclock);
+    xfce_panel_plugin_menu_insert_item(plugin, GTK_MENU_ITEM(item));
+    gtk_widget_show(item);
+}
+
 /* Plugin constructor */
 static void
 axisclock_construct(XfcePanelPlugin *plugin)
@@ -75,11 +129,21 @@ axisclock_construct(XfcePanelPlugin *plugin)
                      G_CALLBACK(axisclock_show_preferences), axisclock);
     g_signal_connect(G_OBJECT(plugin), "about",
                      G_CALLBACK(axisclock_show_about), NULL);
+    g_signal_connect(G_OBJECT(plugin), "mode-changed",
+                     G_CALLBACK(axisclock_mode_changed), axisclock);
+    g_signal_connect(G_OBJECT(plugin), "size-changed",
+                     G_CALLBACK(axisclock_size_changed), axisclock);
     
     /* Show menu item for configuration */
     xfce_panel_plugin_menu_show_configure(plugin);
     xfce_panel_plugin_menu_show_about(plugin);
     
+    /* Countdown and stopwatch controls */
+    axisclock_menu_add(plugin, "Start _Timer", G_CALLBACK(axisclock_start_timer), axisclock);
+    axisclock_menu_add(plugin, "_Cancel Timer", G_CALLBACK(axisclock_cancel_timer), axisclock);
+    axisclock_menu_add(plugin, "Start/Stop _Stopwatch", G_CALLBACK(axisclock_toggle_stopwatch), axisclock);
+    axisclock_menu_add(plugin, "_Reset Stopwatch", G_CALLBACK(axisclock_reset_stopwatch), axisclock);
+    
     /* Show the plugin */
     gtk_widget_show_all(GTK_WIDGET(plugin));
 }
@@ -37,6 +37,18 @@
 #define DEFAULT_CALENDAR_TRANSPARENCY 0.95
 #define DEFAULT_FONT_NAME "Sans 10"
 #define DEFAULT_USE_CUSTOM_FONT FALSE
+#define DEFAULT_ZONE_DISPLAY PLUGIN_ZONE_DISPLAY_LABEL
+#define DEFAULT_ZONE_FORMAT "%H:%M"
+#define DEFAULT_TIMER_MINUTES 5
+#define DEFAULT_DISPLAY_MODE PLUGIN_DISPLAY_MODE_FORMAT
+#define DEFAULT_FUZZY_MINUTES 5
+#define DEFAULT_BATTERY_POLICY PLUGIN_BATTERY_POLICY_DROP_SECONDS
+#define DEFAULT_SHOW_ASTRONOMY FALSE
+#define DEFAULT_LATITUDE 0.0
+#define DEFAULT_LONGITUDE 0.0
+#define DEFAULT_SHOW_WEEK_NUMBERS FALSE
+#define DEFAULT_HOLIDAY_COUNTRY ""
+#define DEFAULT_SECONDARY_CALENDAR AXISCLOCK_CALENDAR_SYSTEM_NONE
 
 /* Xfconf property names */
 #define PROPERTY_TIME_FORMAT "/time-format"
@@ -44,6 +56,21 @@
 #define PROPERTY_CALENDAR_TRANSPARENCY "/calendar-transparency"
 #define PROPERTY_FONT_NAME "/font-name"
 #define PROPERTY_USE_CUSTOM_FONT "/use-custom-font"
+#define PROPERTY_ZONES "/zones"
+#define PROPERTY_ZONE_DISPLAY "/zone-display"
+#define PROPERTY_ZONE_FORMAT "/zone-format"
+#define PROPERTY_ICS_FILES "/ics-files"
+#define PROPERTY_ALARMS "/alarms"
+#define PROPERTY_TIMER_MINUTES "/timer-minutes"
+#define PROPERTY_DISPLAY_MODE "/display-mode"
+#define PROPERTY_FUZZY_MINUTES "/fuzzy-minutes"
+#define PROPERTY_BATTERY_POLICY "/battery-policy"
+#define PROPERTY_SHOW_ASTRONOMY "/show-astronomy"
+#define PROPERTY_LATITUDE "/latitude"
+#define PROPERTY_LONGITUDE "/longitude"
+#define PROPERTY_SHOW_WEEK_NUMBERS "/show-week-numbers"
+#define PROPERTY_HOLIDAY_COUNTRY "/holiday-country"
+#define PROPERTY_SECONDARY_CALENDAR "/secondary-calendar"
 
 /**
  * plugin_config_new:
@@ -65,6 +92,21 @@ plugin_config_new(void)
     config->calendar_transparency = DEFAULT_CALENDAR_TRANSPARENCY;
     config->font_name = g_strdup(DEFAULT_FONT_NAME);
     config->use_custom_font = DEFAULT_USE_CUSTOM_FONT;
+    config->zones = g_new0(gchar *, 1);
+    config->zone_display = DEFAULT_ZONE_DISPLAY;
+    config->zone_format = g_strdup(DEFAULT_ZONE_FORMAT);
+    config->ics_files = g_new0(gchar *, 1);
+    config->alarms = g_new0(gchar *, 1);
+    config->timer_minutes = DEFAULT_TIMER_MINUTES;
+    config->display_mode = DEFAULT_DISPLAY_MODE;
+    config->fuzzy_minutes = DEFAULT_FUZZY_MINUTES;
+    config->battery_policy = DEFAULT_BATTERY_POLICY;
+    config->show_astronomy = DEFAULT_SHOW_ASTRONOMY;
+    config->latitude = DEFAULT_LATITUDE;
+    config->longitude = DEFAULT_LONGITUDE;
+    config->show_week_numbers = DEFAULT_SHOW_WEEK_NUMBERS;
+    config->holiday_country = g_strdup(DEFAULT_HOLIDAY_COUNTRY);
+    config->secondary_calendar = DEFAULT_SECONDARY_CALENDAR;
     
     return config;
 }
@@ -83,6 +125,11 @@ plugin_config_free(PluginConfig *config)
     
     g_free(config->time_format);
     g_free(config->font_name);
+    g_strfreev(config->zones);
+    g_free(config->zone_format);
+    g_strfreev(config->ics_files);
+    g_strfreev(config->alarms);
+    g_free(config->holiday_country);
     g_free(config);
 }
 
@@ -98,6 +145,9 @@ void
 plugin_config_load(PluginConfig *config, XfconfChannel *channel)
 {
     gchar *value;
+    gchar **zones;
+    gchar **ics_files;
+    gchar **alarms;
     
     g_return_if_fail(config != NULL);
     g_return_if_fail(XFCONF_IS_CHANNEL(channel));
@@ -130,6 +180,74 @@ plugin_config_load(PluginConfig *config, XfconfChannel *channel)
     
     /* Load use custom font option */
     config->use_custom_font = xfconf_channel_get_bool(channel, PROPERTY_USE_CUSTOM_FONT, DEFAULT_USE_CUSTOM_FONT);
+    
+    /* Load additional time zones */
+    zones = xfconf_channel_get_string_list(channel, PROPERTY_ZONES);
+    if (zones != NULL) {
+        g_strfreev(config->zones);
+        config->zones = zones;
+    }
+    
+    /* Load zone display mode */
+    config->zone_display = CLAMP(xfconf_channel_get_int(channel, PROPERTY_ZONE_DISPLAY, DEFAULT_ZONE_DISPLAY),
+                                 PLUGIN_ZONE_DISPLAY_LABEL, PLUGIN_ZONE_DISPLAY_POPUP);
+    
+    /* Load zone format */
+    value = xfconf_channel_get_string(channel, PROPERTY_ZONE_FORMAT, NULL);
+    if (value != NULL) {
+        g_free(config->zone_format);
+        config->zone_format = value;
+    }
+    
+    /* Load event files */
+    ics_files = xfconf_channel_get_string_list(channel, PROPERTY_ICS_FILES);
+    if (ics_files != NULL) {
+        g_strfreev(config->ics_files);
+        config->ics_files = ics_files;
+    }
+    
+    /* Load alarms */
+    alarms = xfconf_channel_get_string_list(channel, PROPERTY_ALARMS);
+    if (alarms != NULL) {
+        g_strfreev(config->alarms);
+        config->alarms = alarms;
+    }
+    
+    /* Load countdown length, at most a day */
+    config->timer_minutes = CLAMP(xfconf_channel_get_uint(channel, PROPERTY_TIMER_MINUTES, DEFAULT_TIMER_MINUTES),
+                                  1, 24 * 60);
+    
+    /* Load display mode */
+    config->display_mode = CLAMP(xfconf_channel_get_int(channel, PROPERTY_DISPLAY_MODE, DEFAULT_DISPLAY_MODE),
+                                 PLUGIN_DISPLAY_MODE_FORMAT, PLUGIN_DISPLAY_MODE_FUZZY);
+    
+    /* Load fuzzy precision; slots must tile the hour in five-minute steps */
+    config->fuzzy_minutes = xfconf_channel_get_uint(channel, PROPERTY_FUZZY_MINUTES, DEFAULT_FUZZY_MINUTES);
+    if (config->fuzzy_minutes == 0 || config->fuzzy_minutes % 5 != 0 || 60 % config->fuzzy_minutes != 0)
+        config->fuzzy_minutes = DEFAULT_FUZZY_MINUTES;
+    
+    /* Load battery policy */
+    config->battery_policy = CLAMP(xfconf_channel_get_int(channel, PROPERTY_BATTERY_POLICY, DEFAULT_BATTERY_POLICY),
+                                   PLUGIN_BATTERY_POLICY_NONE, PLUGIN_BATTERY_POLICY_MINUTES);
+    
+    /* Load sun and moon annotations */
+    config->show_astronomy = xfconf_channel_get_bool(channel, PROPERTY_SHOW_ASTRONOMY, DEFAULT_SHOW_ASTRONOMY);
+    config->latitude = CLAMP(xfconf_channel_get_double(channel, PROPERTY_LATITUDE, DEFAULT_LATITUDE), -90.0, 90.0);
+    config->longitude = CLAMP(xfconf_channel_get_double(channel, PROPERTY_LONGITUDE, DEFAULT_LONGITUDE), -180.0, 180.0);
+    
+    /* Load week numbers option */
+    config->show_week_numbers = xfconf_channel_get_bool(channel, PROPERTY_SHOW_WEEK_NUMBERS, DEFAULT_SHOW_WEEK_NUMBERS);
+    
+    /* Load holiday country */
+    value = xfconf_channel_get_string(channel, PROPERTY_HOLIDAY_COUNTRY, NULL);
+    if (value != NULL) {
+        g_free(config->holiday_country);
+        config->holiday_country = value;
+    }
+    
+    /* Load secondary calendar system */
+    config->secondary_calendar = CLAMP(xfconf_channel_get_int(channel, PROPERTY_SECONDARY_CALENDAR, DEFAULT_SECONDARY_CALENDAR),
+                                       AXISCLOCK_CALENDAR_SYSTEM_NONE, AXISCLOCK_N_CALENDAR_SYSTEMS - 1);
 }
 
 /**
@@ -159,4 +277,54 @@ plugin_config_save(const PluginConfig *config, XfconfChannel *channel)
     
     /* Save use custom font option */
     xfconf_channel_set_bool(channel, PROPERTY_USE_CUSTOM_FONT, config->use_custom_font);
+    
+    /* Save additional time zones; Xfconf has no empty arrays */
+    if (config->zones != NULL && config->zones[0] != NULL)
+        xfconf_channel_set_string_list(channel, PROPERTY_ZONES, (const gchar * const *)config->zones);
+    else
+        xfconf_channel_reset_property(channel, PROPERTY_ZONES, FALSE);
+    
+    /* Save zone display mode */
+    xfconf_channel_set_int(channel, PROPERTY_ZONE_DISPLAY, config->zone_display);
+    
+    /* Save zone format */
+    xfconf_channel_set_string(channel, PROPERTY_ZONE_FORMAT, config->zone_format);
+    
+    /* Save event files */
+    if (config->ics_files != NULL && config->ics_files[0] != NULL)
+        xfconf_channel_set_string_list(channel, PROPERTY_ICS_FILES, (const gchar * const *)config->ics_files);
+    else
+        xfconf_channel_reset_property(channel, PROPERTY_ICS_FILES, FALSE);
+    
+    /* Save alarms */
+    if (config->alarms != NULL && config->alarms[0] != NULL)
+        xfconf_channel_set_string_list(channel, PROPERTY_ALARMS, (const gchar * const *)config->alarms);
+    else
+        xfconf_channel_reset_property(channel, PROPERTY_ALARMS, FALSE);
+    
+    /* Save countdown length */
+    xfconf_channel_set_uint(channel, PROPERTY_TIMER_MINUTES, config->timer_minutes);
+    
+    /* Save display mode */
+    xfconf_channel_set_int(channel, PROPERTY_DISPLAY_MODE, config->display_mode);
+    
+    /* Save fuzzy precision */
+    xfconf_channel_set_uint(channel, PROPERTY_FUZZY_MINUTES, config->fuzzy_minutes);
+    
+    /* Save battery policy */
+    xfconf_channel_set_int(channel, PROPERTY_BATTERY_POLICY, config->battery_policy);
+    
+    /* Save sun and moon annotations */
+    xfconf_channel_set_bool(channel, PROPERTY_SHOW_ASTRONOMY, config->show_astronomy);
+    xfconf_channel_set_double(channel, PROPERTY_LATITUDE, config->latitude);
+    xfconf_channel_set_double(channel, PROPERTY_LONGITUDE, config->longitude);
+    
+    /* Save week numbers option */
+    xfconf_channel_set_bool(channel, PROPERTY_SHOW_WEEK_NUMBERS, config->show_week_numbers);
+    
+    /* Save holiday country */
+    xfconf_channel_set_string(channel, PROPERTY_HOLIDAY_COUNTRY, config->holiday_country);
+    
+    /* Save secondary calendar system */
+    xfconf_channel_set_int(channel, PROPERTY_SECONDARY_CALENDAR, config->secondary_calendar);
 }
@@ -27,8 +27,30 @@
 #include <glib.h>
 #include <xfconf/xfconf.h>
 
+#include "calendar_systems.h"
+
 G_BEGIN_DECLS
 
+/* What the panel label shows */
+typedef enum {
+    PLUGIN_DISPLAY_MODE_FORMAT,     /* strftime time format */
+    PLUGIN_DISPLAY_MODE_FUZZY       /* "Quarter past ten" */
+} PluginDisplayMode;
+
+/* How much precision the label gives up while on battery */
+typedef enum {
+    PLUGIN_BATTERY_POLICY_NONE,         /* Same updates as on AC */
+    PLUGIN_BATTERY_POLICY_DROP_SECONDS, /* Clock per minute, running timers per second */
+    PLUGIN_BATTERY_POLICY_MINUTES       /* Everything per minute */
+} PluginBatteryPolicy;
+
+/* Where the additional time zones are rendered */
+typedef enum {
+    PLUGIN_ZONE_DISPLAY_LABEL,
+    PLUGIN_ZONE_DISPLAY_TOOLTIP,
+    PLUGIN_ZONE_DISPLAY_POPUP
+} PluginZoneDisplay;
+
 /**
  * PluginConfig:
  * @time_format: The time format string
@@ -36,6 +58,21 @@ G_BEGIN_DECLS
  * @calendar_transparency: Transparency level for the calendar popup (0.0 to 1.0)
  * @font_name: Font name for the clock display
  * @use_custom_font: Whether to use a custom font
+ * @zones: %NULL-terminated list of additional Olson time zones
+ * @zone_display: Where the additional zones are shown
+ * @zone_format: strftime format used for each additional zone
+ * @ics_files: %NULL-terminated list of .ics files or directories marked in the calendar
+ * @alarms: %NULL-terminated list of daily alarms, "HH:MM[ message]"
+ * @timer_minutes: Length of the countdown started from the panel menu
+ * @display_mode: Whether the label uses @time_format or fuzzy phrases
+ * @fuzzy_minutes: Fuzzy time precision, a multiple of 5 that divides 60
+ * @battery_policy: Update precision given up while on battery
+ * @show_astronomy: Whether the calendar shows sunrise, sunset and moon phases
+ * @latitude: Location for @show_astronomy, degrees north
+ * @longitude: Location for @show_astronomy, degrees east
+ * @show_week_numbers: Whether the calendar shows ISO week numbers
+ * @holiday_country: ISO 3166 code of the country whose holidays are marked, "" for none
+ * @secondary_calendar: Calendar system shown under the Gregorian days
  *
  * Configuration structure for the AxisClock plugin.
  */
@@ -45,6 +82,21 @@ typedef struct _PluginConfig {
     gdouble   calendar_transparency;
     gchar    *font_name;
     gboolean  use_custom_font;
+    gchar   **zones;
+    PluginZoneDisplay zone_display;
+    gchar    *zone_format;
+    gchar   **ics_files;
+    gchar   **alarms;
+    guint     timer_minutes;
+    PluginDisplayMode display_mode;
+    guint     fuzzy_minutes;
+    PluginBatteryPolicy battery_policy;
+    gboolean  show_astronomy;
+    gdouble   latitude;
+    gdouble   longitude;
+    gboolean  show_week_numbers;
+    gchar    *holiday_country;
+    AxisClockCalendarSystem secondary_calendar;
 } PluginConfig;
 
 /* Function prototypes */
@@ -0,0 +1,197 @@
+/*
+ * xfce4-axisclock-plugin - A macOS-style clock plugin for the Xfce panel
+ *
+ * Copyright (c) 2025 Kamil 'Novik' Nowicki <novik@axisos.org>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Website: https://axisos.org
+ * Repository: https://github.com/AxisOS/xfce4-axisclock-plugin
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <gio/gio.h>
+
+#include "power_monitor.h"
+
+#define UPOWER_NAME      "org.freedesktop.UPower"
+#define UPOWER_PATH      "/org/freedesktop/UPower"
+#define UPOWER_INTERFACE "org.freedesktop.UPower"
+
+struct _AxisClockPowerWatch {
+    AxisClockPowerFunc func;
+    gpointer           user_data;
+};
+
+typedef struct {
+    GList        *watches;
+    GCancellable *cancellable;
+    GDBusProxy   *proxy;
+    gboolean      on_battery;
+} PowerMonitor;
+
+static PowerMonitor *monitor = NULL;
+
+/* Tell every watch about a changed power state */
+static void
+power_monitor_set_on_battery(gboolean on_battery)
+{
+    GList *l, *next;
+    
+    if (monitor->on_battery == on_battery)
+        return;
+    
+    monitor->on_battery = on_battery;
+    
+    for (l = monitor->watches; l != NULL; l = next) {
+        AxisClockPowerWatch *watch = l->data;
+        
+        /* Saved first: the callback may unwatch itself */
+        next = l->next;
+        watch->func(on_battery, watch->user_data);
+    }
+}
+
+/* Read OnBattery from the proxy's property cache */
+static void
+power_monitor_sync(void)
+{
+    GVariant *value = g_dbus_proxy_get_cached_property(monitor->proxy, "OnBattery");
+    
+    if (value == NULL)
+        return;
+    
+    power_monitor_set_on_battery(g_variant_get_boolean(value));
+    g_variant_unref(value);
+}
+
+static void
+power_monitor_properties_changed_cb(GDBusProxy *proxy G_GNUC_UNUSED, GVariant *changed G_GNUC_UNUSED,
+                                    GStrv invalidated G_GNUC_UNUSED, gpointer data G_GNUC_UNUSED)
+{
+    power_monitor_sync();
+}
+
+static void
+power_monitor_proxy_ready_cb(GObject *source G_GNUC_UNUSED, GAsyncResult *result, gpointer data G_GNUC_UNUSED)
+{
+    GError *error = NULL;
+    GDBusProxy *proxy = g_dbus_proxy_new_for_bus_finish(result, &error);
+    
+    if (proxy == NULL) {
+        /* The monitor is gone if the request was cancelled */
+        if (!g_error_matches(error, G_IO_ERROR, G_IO_ERROR_CANCELLED))
+            g_debug("UPower unavailable, assuming AC power: %s", error->message);
+        g_error_free(error);
+        return;
+    }
+    
+    monitor->proxy = proxy;
+    g_signal_connect(proxy, "g-properties-changed", G_CALLBACK(power_monitor_properties_changed_cb), NULL);
+    power_monitor_sync();
+}
+
+static void
+power_monitor_ref(void)
+{
+    const gchar *override;
+    
+    if (monitor != NULL)
+        return;
+    
+    monitor = g_new0(PowerMonitor, 1);
+    
+    override = g_getenv(AXISCLOCK_POWER_OVERRIDE_ENV);
+    if (override != NULL) {
+        monitor->on_battery = g_strcmp0(override, "1") == 0;
+        return;
+    }
+    
+    monitor->cancellable = g_cancellable_new();
+    g_dbus_proxy_new_for_bus(G_BUS_TYPE_SYSTEM, G_DBUS_PROXY_FLAGS_DO_NOT_AUTO_START, NULL,
+                             UPOWER_NAME, UPOWER_PATH, UPOWER_INTERFACE, monitor->cancellable,
+                             power_monitor_proxy_ready_cb, NULL);
+}
+
+static void
+power_monitor_unref(void)
+{
+    if (monitor == NULL || monitor->watches != NULL)
+        return;
+    
+    if (monitor->cancellable != NULL) {
+        g_cancellable_cancel(monitor->cancellable);
+        g_object_unref(monitor->cancellable);
+    }
+    if (monitor->proxy != NULL) {
+        g_signal_handlers_disconnect_by_func(monitor->proxy, power_monitor_properties_changed_cb, NULL);
+        g_object_unref(monitor->proxy);
+    }
+    g_clear_pointer(&monitor, g_free);
+}
+
+/**
+ * axisclock_power_monitor_watch:
+ * @func: Called whenever the system switches between battery and AC
+ * @user_data: Passed to @func
+ *
+ * Returns: A watch to pass to axisclock_power_monitor_unwatch().
+ */
+AxisClockPowerWatch *
+axisclock_power_monitor_watch(AxisClockPowerFunc func, gpointer user_data)
+{
+    AxisClockPowerWatch *watch;
+    
+    g_return_val_if_fail(func != NULL, NULL);
+    
+    power_monitor_ref();
+    
+    watch = g_new0(AxisClockPowerWatch, 1);
+    watch->func = func;
+    watch->user_data = user_data;
+    monitor->watches = g_list_append(monitor->watches, watch);
+    
+    return watch;
+}
+
+/**
+ * axisclock_power_monitor_unwatch:
+ * @watch: A watch
+ *
+ * Stops calling @watch; the last one stops listening to UPower.
+ */
+void
+axisclock_power_monitor_unwatch(AxisClockPowerWatch *watch)
+{
+    g_return_if_fail(monitor != NULL && watch != NULL);
+    
+    monitor->watches = g_list_remove(monitor->watches, watch);
+    g_free(watch);
+    power_monitor_unref();
+}
+
+/**
+ * axisclock_power_monitor_on_battery:
+ *
+ * Returns: %TRUE if the system is known to run on battery.
+ */
+gboolean
+axisclock_power_monitor_on_battery(void)
+{
+    return monitor != NULL && monitor->on_battery;
+}
@@ -0,0 +1,52 @@
+/*
+ * xfce4-axisclock-plugin - A macOS-style clock plugin for the Xfce panel
+ *
+ * Copyright (c) 2025 Kamil 'Novik' Nowicki <novik@axisos.org>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Website: https://axisos.org
+ * Repository: https://github.com/AxisOS/xfce4-axisclock-plugin
+ */
+
+#ifndef __POWER_MONITOR_H__
+#define __POWER_MONITOR_H__
+
+#include <glib.h>
+
+G_BEGIN_DECLS
+
+/* Forces the power state instead of asking UPower, e.g. AXISCLOCK_ON_BATTERY=1 */
+#define AXISCLOCK_POWER_OVERRIDE_ENV "AXISCLOCK_ON_BATTERY"
+
+typedef struct _AxisClockPowerWatch AxisClockPowerWatch;
+
+typedef void (*AxisClockPowerFunc) (gboolean on_battery,
+                                    gpointer user_data);
+
+/*
+ * Process-wide view of UPower's OnBattery property, created with the first
+ * watch and dropped with the last. Until UPower answers, and when it is
+ * not running, the system counts as plugged in. Setting
+ * AXISCLOCK_ON_BATTERY to 0 or 1 replaces UPower with a fixed state.
+ */
+AxisClockPowerWatch *axisclock_power_monitor_watch      (AxisClockPowerFunc   func,
+                                                         gpointer             user_data);
+void                 axisclock_power_monitor_unwatch    (AxisClockPowerWatch *watch);
+gboolean             axisclock_power_monitor_on_battery (void);
+
+G_END_DECLS
+
+#endif /* !__POWER_MONITOR_H__ */
@@ -32,6 +32,11 @@
 #include "preferences_dialog.h"
 #include "clock_widget.h"
 #include "plugin_config.h"
+#include "holidays.h"
+#include "zone_index.h"
+
+/* Result rows of the zone picker, reused by every search */
+#define ZONE_PICKER_ROWS 12
 
 /* Dialog response callback */
 static void
@@ -107,6 +112,34 @@ show_date_toggled_cb(GtkToggleButton *button, AxisClockPlugin *axisclock)
     axisclock_update_time(axisclock);
 }
 
+/* Fuzzy time toggle callback */
+static void
+fuzzy_toggled_cb(GtkToggleButton *button, AxisClockPlugin *axisclock)
+{
+    GtkWidget *combo = g_object_get_data(G_OBJECT(button), "precision-combo");
+    
+    axisclock->config->display_mode = gtk_toggle_button_get_active(button) ? PLUGIN_DISPLAY_MODE_FUZZY
+                                                                           : PLUGIN_DISPLAY_MODE_FORMAT;
+    gtk_widget_set_sensitive(combo, axisclock->config->display_mode == PLUGIN_DISPLAY_MODE_FUZZY);
+    axisclock_update_time(axisclock);
+}
+
+/* Fuzzy precision changed callback */
+static void
+fuzzy_precision_changed_cb(GtkComboBox *combo, AxisClockPlugin *axisclock)
+{
+    axisclock->config->fuzzy_minutes = (guint)g_ascii_strtoull(gtk_combo_box_get_active_id(combo), NULL, 10);
+    axisclock_update_time(axisclock);
+}
+
+/* Battery policy changed callback */
+static void
+battery_policy_changed_cb(GtkComboBox *combo, AxisClockPlugin *axisclock)
+{
+    axisclock->config->battery_policy = gtk_combo_box_get_active(combo);
+    axisclock_update_time(axisclock);
+}
+
 /* Use custom font toggle callback */
 static void
 use_custom_font_toggled_cb(GtkToggleButton *button, AxisClockPlugin *axisclock)
@@ -133,18 +166,285 @@ font_changed_cb(GtkFontButton *button, AxisClockPlugin *axisclock)
     /* TODO: Apply font changes */
 }
 
+/* Split a comma-separated entry into a trimmed list without empty items */
+static gchar **
+entry_get_list(GtkEntry *entry)
+{
+    gchar **items = g_strsplit(gtk_entry_get_text(entry), ",", -1);
+    guint n = 0;
+    
+    for (guint i = 0; items[i] != NULL; i++) {
+        g_strstrip(items[i]);
+        if (*items[i] != '\0')
+            items[n++] = items[i];
+        else
+            g_free(items[i]);
+    }
+    items[n] = NULL;
+    
+    return items;
+}
+
+/* Apply the comma-separated zone list from the entry */
+static void
+zones_entry_apply(GtkEntry *entry, AxisClockPlugin *axisclock)
+{
+    g_strfreev(axisclock->config->zones);
+    axisclock->config->zones = entry_get_list(entry);
+    axisclock_reload_zones(axisclock);
+}
+
+/* Zone entry activated callback */
+static void
+zones_entry_activate_cb(GtkEntry *entry, AxisClockPlugin *axisclock)
+{
+    zones_entry_apply(entry, axisclock);
+}
+
+/* Zone entry focus-out callback */
+static gboolean
+zones_entry_focus_out_cb(GtkWidget *entry, GdkEventFocus *event G_GNUC_UNUSED, AxisClockPlugin *axisclock)
+{
+    zones_entry_apply(GTK_ENTRY(entry), axisclock);
+    return FALSE;
+}
+
+/* One reusable zone picker row: name and country, UTC offset */
+static GtkWidget *
+zone_picker_row_new(void)
+{
+    GtkWidget *row = gtk_list_box_row_new();
+    GtkWidget *box = gtk_box_new(GTK_ORIENTATION_HORIZONTAL, 12);
+    GtkWidget *name = gtk_label_new(NULL);
+    GtkWidget *offset = gtk_label_new(NULL);
+    
+    gtk_widget_set_halign(name, GTK_ALIGN_START);
+    gtk_widget_set_hexpand(name, TRUE);
+    gtk_label_set_ellipsize(GTK_LABEL(name), PANGO_ELLIPSIZE_END);
+    gtk_style_context_add_class(gtk_widget_get_style_context(offset), "dim-label");
+    gtk_box_pack_start(GTK_BOX(box), name, TRUE, TRUE, 0);
+    gtk_box_pack_start(GTK_BOX(box), offset, FALSE, FALSE, 0);
+    gtk_container_set_border_width(GTK_CONTAINER(box), 3);
+    gtk_container_add(GTK_CONTAINER(row), box);
+    gtk_widget_show_all(box);
+    
+    /* Shown only while it holds a result */
+    gtk_widget_set_no_show_all(row, TRUE);
+    g_object_set_data(G_OBJECT(row), "name-label", name);
+    g_object_set_data(G_OBJECT(row), "offset-label", offset);
+    
+    return row;
+}
+
+/* Zone search changed callback; only relabels the existing rows */
+static void
+zone_search_changed_cb(GtkSearchEntry *search, GtkListBox *list)
+{
+    const AxisClockZoneInfo *results[ZONE_PICKER_ROWS];
+    GtkWidget *scrolled = g_object_get_data(G_OBJECT(list), "scrolled");
+    guint n = axisclock_zone_index_search(gtk_entry_get_text(GTK_ENTRY(search)), results, ZONE_PICKER_ROWS);
+    
+    for (guint i = 0; i < ZONE_PICKER_ROWS; i++) {
+        GtkListBoxRow *row = gtk_list_box_get_row_at_index(list, i);
+        
+        if (i < n) {
+            gint offset = ABS(results[i]->offset);
+            gchar *markup = g_markup_printf_escaped("<b>%s</b>%s%s  <small>%s</small>", results[i]->city,
+                                                    *results[i]->country != '\0' ? ", " : "",
+                                                    results[i]->country, results[i]->identifier);
+            gchar *text = g_strdup_printf("UTC%c%02d:%02d", results[i]->offset < 0 ? '-' : '+',
+                                          offset / 3600, (offset / 60) % 60);
+            
+            gtk_label_set_markup(GTK_LABEL(g_object_get_data(G_OBJECT(row), "name-label")), markup);
+            gtk_label_set_text(GTK_LABEL(g_object_get_data(G_OBJECT(row), "offset-label")), text);
+            g_object_set_data(G_OBJECT(row), "identifier", (gpointer)results[i]->identifier);
+            g_free(markup);
+            g_free(text);
+        }
+        gtk_widget_set_visible(GTK_WIDGET(row), i < n);
+    }
+    
+    gtk_widget_set_visible(scrolled, n > 0);
+}
+
+/* Zone picker row activated callback; appends the zone to the list */
+static void
+zone_row_activated_cb(GtkListBox *list, GtkListBoxRow *row, AxisClockPlugin *axisclock)
+{
+    const gchar *identifier = g_object_get_data(G_OBJECT(row), "identifier");
+    GtkEntry *entry = g_object_get_data(G_OBJECT(list), "zones-entry");
+    const gchar *current;
+    gchar *text;
+    
+    if (identifier == NULL || g_strv_contains((const gchar * const *)axisclock->config->zones, identifier))
+        return;
+    
+    current = gtk_entry_get_text(entry);
+    text = *current != '\0' ? g_strconcat(current, ", ", identifier, NULL) : g_strdup(identifier);
+    gtk_entry_set_text(entry, text);
+    g_free(text);
+    
+    zones_entry_apply(entry, axisclock);
+}
+
+/* Zone display mode changed callback */
+static void
+zone_display_changed_cb(GtkComboBox *combo, AxisClockPlugin *axisclock)
+{
+    axisclock->config->zone_display = gtk_combo_box_get_active(combo);
+    axisclock_reload_zones(axisclock);
+}
+
+/* Zone format changed callback */
+static void
+zone_format_changed_cb(GtkEntry *entry, AxisClockPlugin *axisclock)
+{
+    g_free(axisclock->config->zone_format);
+    axisclock->config->zone_format = g_strdup(gtk_entry_get_text(entry));
+    axisclock_update_time(axisclock);
+}
+
+/* Event files entry focus-out callback */
+static gboolean
+ics_entry_focus_out_cb(GtkWidget *entry, GdkEventFocus *event G_GNUC_UNUSED, AxisClockPlugin *axisclock)
+{
+    gchar **ics_files = entry_get_list(GTK_ENTRY(entry));
+    gchar *new_text = g_strjoinv("\n", ics_files);
+    gchar *old_text = g_strjoinv("\n", axisclock->config->ics_files);
+    
+    /* Re-indexing is not free; only restart when the list changed */
+    if (g_strcmp0(new_text, old_text) != 0) {
+        g_strfreev(axisclock->config->ics_files);
+        axisclock->config->ics_files = ics_files;
+        axisclock_calendar_set_event_sources(axisclock->calendar,
+                                             (const gchar * const *)axisclock->config->ics_files);
+    } else {
+        g_strfreev(ics_files);
+    }
+    
+    g_free(new_text);
+    g_free(old_text);
+    
+    return FALSE;
+}
+
+/* Event files entry activated callback */
+static void
+ics_entry_activate_cb(GtkEntry *entry, AxisClockPlugin *axisclock)
+{
+    ics_entry_focus_out_cb(GTK_WIDGET(entry), NULL, axisclock);
+}
+
+/* Apply the comma-separated alarm list from the entry */
+static void
+alarms_entry_apply(GtkEntry *entry, AxisClockPlugin *axisclock)
+{
+    g_strfreev(axisclock->config->alarms);
+    axisclock->config->alarms = entry_get_list(entry);
+    axisclock_alarms_set_schedule(axisclock->alarms, (const gchar * const *)axisclock->config->alarms);
+}
+
+/* Alarm entry activated callback */
+static void
+alarms_entry_activate_cb(GtkEntry *entry, AxisClockPlugin *axisclock)
+{
+    alarms_entry_apply(entry, axisclock);
+}
+
+/* Alarm entry focus-out callback */
+static gboolean
+alarms_entry_focus_out_cb(GtkWidget *entry, GdkEventFocus *event G_GNUC_UNUSED, AxisClockPlugin *axisclock)
+{
+    alarms_entry_apply(GTK_ENTRY(entry), axisclock);
+    return FALSE;
+}
+
+/* Countdown length changed callback */
+static void
+timer_minutes_changed_cb(GtkSpinButton *spin, AxisClockPlugin *axisclock)
+{
+    axisclock->config->timer_minutes = gtk_spin_button_get_value_as_int(spin);
+}
+
+/* Week numbers toggle callback */
+static void
+show_week_numbers_toggled_cb(GtkToggleButton *button, AxisClockPlugin *axisclock)
+{
+    axisclock->config->show_week_numbers = gtk_toggle_button_get_active(button);
+    axisclock_calendar_set_week_numbers(axisclock->calendar, axisclock->config->show_week_numbers);
+}
+
+/* Holiday country changed callback */
+static void
+holiday_country_changed_cb(GtkComboBox *combo, AxisClockPlugin *axisclock)
+{
+    g_free(axisclock->config->holiday_country);
+    axisclock->config->holiday_country = g_strdup(gtk_combo_box_get_active_id(combo));
+    axisclock_calendar_set_holidays(axisclock->calendar, axisclock->config->holiday_country);
+}
+
+/* Secondary calendar system changed callback */
+static void
+secondary_calendar_changed_cb(GtkComboBox *combo, AxisClockPlugin *axisclock)
+{
+    axisclock->config->secondary_calendar = gtk_combo_box_get_active(combo);
+    axisclock_calendar_set_secondary_calendar(axisclock->calendar, axisclock->config->secondary_calendar);
+}
+
+/* Push the location settings to the calendar */
+static void
+astronomy_apply(AxisClockPlugin *axisclock)
+{
+    axisclock_calendar_set_location(axisclock->calendar, axisclock->config->show_astronomy,
+                                    axisclock->config->latitude, axisclock->config->longitude);
+}
+
+/* Sun and moon toggle callback */
+static void
+show_astronomy_toggled_cb(GtkToggleButton *button, AxisClockPlugin *axisclock)
+{
+    GtkWidget *location_box = g_object_get_data(G_OBJECT(button), "location-box");
+    
+    axisclock->config->show_astronomy = gtk_toggle_button_get_active(button);
+    gtk_widget_set_sensitive(location_box, axisclock->config->show_astronomy);
+    astronomy_apply(axisclock);
+}
+
+/* Latitude changed callback */
+static void
+latitude_changed_cb(GtkSpinButton *spin, AxisClockPlugin *axisclock)
+{
+    axisclock->config->latitude = gtk_spin_button_get_value(spin);
+    astronomy_apply(axisclock);
+}
+
+/* Longitude changed callback */
+static void
+longitude_changed_cb(GtkSpinButton *spin, AxisClockPlugin *axisclock)
+{
+    axisclock->config->longitude = gtk_spin_button_get_value(spin);
+    astronomy_apply(axisclock);
+}
+
 /* Show preferences dialog */
 void
 axisclock_preferences_dialog_show(AxisClockPlugin *axisclock)
 {
     GtkWidget *dialog;
     GtkWidget *content_area;
-    GtkWidget *time_grid, *font_grid, *calendar_grid;
+    GtkWidget *time_grid, *font_grid, *calendar_grid, *zones_grid, *alarms_grid;
     GtkWidget *label;
     GtkWidget *widget;
     GtkWidget *frame;
     GtkWidget *vbox;
     GtkWidget *font_button;
+    gchar *zones_text;
+    gchar *ics_text;
+    gchar *alarms_text;
+    gchar *fuzzy_id;
+    GtkWidget *combo;
+    GtkWidget *location_box;
+    GtkWidget *zone_list;
     gint row;
     
     g_print("DEBUG: preferences_dialog_show called\n");
@@ -244,6 +544,176 @@ axisclock_preferences_dialog_show(AxisClockPlugin *axisclock)
     gtk_grid_attach(GTK_GRID(time_grid), widget, 0, row, 2, 1);
     row++;
     
+    /* Fuzzy time */
+    widget = gtk_check_button_new_with_mnemonic("Show fu_zzy time (\"Quarter past ten\")");
+    gtk_toggle_button_set_active(GTK_TOGGLE_BUTTON(widget),
+                                 axisclock->config->display_mode == PLUGIN_DISPLAY_MODE_FUZZY);
+    gtk_grid_attach(GTK_GRID(time_grid), widget, 0, row, 2, 1);
+    row++;
+    
+    label = gtk_label_new_with_mnemonic("_Precision:");
+    gtk_widget_set_halign(label, GTK_ALIGN_START);
+    gtk_grid_attach(GTK_GRID(time_grid), label, 0, row, 1, 1);
+    
+    combo = gtk_combo_box_text_new();
+    gtk_combo_box_text_append(GTK_COMBO_BOX_TEXT(combo), "5", "5 minutes");
+    gtk_combo_box_text_append(GTK_COMBO_BOX_TEXT(combo), "15", "15 minutes");
+    gtk_combo_box_text_append(GTK_COMBO_BOX_TEXT(combo), "30", "30 minutes");
+    gtk_combo_box_text_append(GTK_COMBO_BOX_TEXT(combo), "60", "1 hour");
+    fuzzy_id = g_strdup_printf("%u", axisclock->config->fuzzy_minutes);
+    if (!gtk_combo_box_set_active_id(GTK_COMBO_BOX(combo), fuzzy_id))
+        gtk_combo_box_set_active(GTK_COMBO_BOX(combo), 0);
+    g_free(fuzzy_id);
+    gtk_widget_set_sensitive(combo, axisclock->config->display_mode == PLUGIN_DISPLAY_MODE_FUZZY);
+    gtk_label_set_mnemonic_widget(GTK_LABEL(label), combo);
+    g_signal_connect(combo, "changed", G_CALLBACK(fuzzy_precision_changed_cb), axisclock);
+    gtk_grid_attach(GTK_GRID(time_grid), combo, 1, row, 1, 1);
+    row++;
+    
+    g_object_set_data(G_OBJECT(widget), "precision-combo", combo);
+    g_signal_connect(widget, "toggled", G_CALLBACK(fuzzy_toggled_cb), axisclock);
+    
+    /* Battery policy, in PluginBatteryPolicy order */
+    label = gtk_label_new_with_mnemonic("On _battery:");
+    gtk_widget_set_halign(label, GTK_ALIGN_START);
+    gtk_grid_attach(GTK_GRID(time_grid), label, 0, row, 1, 1);
+    
+    combo = gtk_combo_box_text_new();
+    gtk_combo_box_text_append_text(GTK_COMBO_BOX_TEXT(combo), "Keep full precision");
+    gtk_combo_box_text_append_text(GTK_COMBO_BOX_TEXT(combo), "Drop seconds from the clock");
+    gtk_combo_box_text_append_text(GTK_COMBO_BOX_TEXT(combo), "Update everything once a minute");
+    gtk_combo_box_set_active(GTK_COMBO_BOX(combo), axisclock->config->battery_policy);
+    gtk_label_set_mnemonic_widget(GTK_LABEL(label), combo);
+    g_signal_connect(combo, "changed", G_CALLBACK(battery_policy_changed_cb), axisclock);
+    gtk_grid_attach(GTK_GRID(time_grid), combo, 1, row, 1, 1);
+    row++;
+    
+    /* World Clocks Frame */
+    frame = gtk_frame_new("World Clocks");
+    gtk_box_pack_start(GTK_BOX(vbox), frame, FALSE, FALSE, 0);
+    zones_grid = gtk_grid_new();
+    gtk_container_add(GTK_CONTAINER(frame), zones_grid);
+    gtk_container_set_border_width(GTK_CONTAINER(zones_grid), 6);
+    gtk_grid_set_column_spacing(GTK_GRID(zones_grid), 12);
+    gtk_grid_set_row_spacing(GTK_GRID(zones_grid), 6);
+    row = 0;
+    
+    /* Zone list */
+    label = gtk_label_new_with_mnemonic("_Time zones:");
+    gtk_widget_set_halign(label, GTK_ALIGN_START);
+    gtk_grid_attach(GTK_GRID(zones_grid), label, 0, row, 1, 1);
+    
+    widget = gtk_entry_new();
+    zones_text = g_strjoinv(", ", axisclock->config->zones);
+    gtk_entry_set_text(GTK_ENTRY(widget), zones_text);
+    g_free(zones_text);
+    gtk_entry_set_placeholder_text(GTK_ENTRY(widget), "Europe/London, Asia/Tokyo");
+    gtk_widget_set_hexpand(widget, TRUE);
+    gtk_label_set_mnemonic_widget(GTK_LABEL(label), widget);
+    g_signal_connect(widget, "activate", G_CALLBACK(zones_entry_activate_cb), axisclock);
+    g_signal_connect(widget, "focus-out-event", G_CALLBACK(zones_entry_focus_out_cb), axisclock);
+    gtk_grid_attach(GTK_GRID(zones_grid), widget, 1, row, 1, 1);
+    row++;
+    
+    /* Zone picker; the search index is built on the first keystroke */
+    zone_list = gtk_list_box_new();
+    gtk_list_box_set_activate_on_single_click(GTK_LIST_BOX(zone_list), TRUE);
+    for (guint i = 0; i < ZONE_PICKER_ROWS; i++)
+        gtk_container_add(GTK_CONTAINER(zone_list), zone_picker_row_new());
+    g_object_set_data(G_OBJECT(zone_list), "zones-entry", widget);
+    g_signal_connect(zone_list, "row-activated", G_CALLBACK(zone_row_activated_cb), axisclock);
+    
+    label = gtk_label_new_with_mnemonic("_Find zone:");
+    gtk_widget_set_halign(label, GTK_ALIGN_START);
+    gtk_grid_attach(GTK_GRID(zones_grid), label, 0, row, 1, 1);
+    
+    widget = gtk_search_entry_new();
+    gtk_entry_set_placeholder_text(GTK_ENTRY(widget), "City, country or zone");
+    gtk_widget_set_hexpand(widget, TRUE);
+    gtk_label_set_mnemonic_widget(GTK_LABEL(label), widget);
+    g_signal_connect(widget, "search-changed", G_CALLBACK(zone_search_changed_cb), zone_list);
+    gtk_grid_attach(GTK_GRID(zones_grid), widget, 1, row, 1, 1);
+    row++;
+    
+    widget = gtk_scrolled_window_new(NULL, NULL);
+    gtk_scrolled_window_set_policy(GTK_SCROLLED_WINDOW(widget), GTK_POLICY_NEVER, GTK_POLICY_AUTOMATIC);
+    gtk_scrolled_window_set_min_content_height(GTK_SCROLLED_WINDOW(widget), 150);
+    gtk_scrolled_window_set_shadow_type(GTK_SCROLLED_WINDOW(widget), GTK_SHADOW_IN);
+    gtk_container_add(GTK_CONTAINER(widget), zone_list);
+    gtk_widget_show_all(widget);
+    gtk_widget_set_no_show_all(widget, TRUE);
+    gtk_widget_hide(widget);
+    g_object_set_data(G_OBJECT(zone_list), "scrolled", widget);
+    gtk_grid_attach(GTK_GRID(zones_grid), widget, 0, row, 2, 1);
+    row++;
+    
+    /* Where to show them */
+    label = gtk_label_new_with_mnemonic("_Show in:");
+    gtk_widget_set_halign(label, GTK_ALIGN_START);
+    gtk_grid_attach(GTK_GRID(zones_grid), label, 0, row, 1, 1);
+    
+    widget = gtk_combo_box_text_new();
+    gtk_combo_box_text_append_text(GTK_COMBO_BOX_TEXT(widget), "Panel label");
+    gtk_combo_box_text_append_text(GTK_COMBO_BOX_TEXT(widget), "Tooltip");
+    gtk_combo_box_text_append_text(GTK_COMBO_BOX_TEXT(widget), "Calendar popup");
+    gtk_combo_box_set_active(GTK_COMBO_BOX(widget), axisclock->config->zone_display);
+    gtk_label_set_mnemonic_widget(GTK_LABEL(label), widget);
+    g_signal_connect(widget, "changed", G_CALLBACK(zone_display_changed_cb), axisclock);
+    gtk_grid_attach(GTK_GRID(zones_grid), widget, 1, row, 1, 1);
+    row++;
+    
+    /* Per-zone format */
+    label = gtk_label_new_with_mnemonic("Zone f_ormat:");
+    gtk_widget_set_halign(label, GTK_ALIGN_START);
+    gtk_grid_attach(GTK_GRID(zones_grid), label, 0, row, 1, 1);
+    
+    widget = gtk_entry_new();
+    gtk_entry_set_text(GTK_ENTRY(widget), axisclock->config->zone_format);
+    gtk_widget_set_hexpand(widget, TRUE);
+    gtk_label_set_mnemonic_widget(GTK_LABEL(label), widget);
+    g_signal_connect(widget, "changed", G_CALLBACK(zone_format_changed_cb), axisclock);
+    gtk_grid_attach(GTK_GRID(zones_grid), widget, 1, row, 1, 1);
+    row++;
+    
+    /* Alarms & Timers Frame */
+    frame = gtk_frame_new("Alarms & Timers");
+    gtk_box_pack_start(GTK_BOX(vbox), frame, FALSE, FALSE, 0);
+    alarms_grid = gtk_grid_new();
+    gtk_container_add(GTK_CONTAINER(frame), alarms_grid);
+    gtk_container_set_border_width(GTK_CONTAINER(alarms_grid), 6);
+    gtk_grid_set_column_spacing(GTK_GRID(alarms_grid), 12);
+    gtk_grid_set_row_spacing(GTK_GRID(alarms_grid), 6);
+    row = 0;
+    
+    /* Daily alarms */
+    label = gtk_label_new_with_mnemonic("_Alarms:");
+    gtk_widget_set_halign(label, GTK_ALIGN_START);
+    gtk_grid_attach(GTK_GRID(alarms_grid), label, 0, row, 1, 1);
+    
+    widget = gtk_entry_new();
+    alarms_text = g_strjoinv(", ", axisclock->config->alarms);
+    gtk_entry_set_text(GTK_ENTRY(widget), alarms_text);
+    g_free(alarms_text);
+    gtk_entry_set_placeholder_text(GTK_ENTRY(widget), "09:30 Standup, 12:00 Lunch");
+    gtk_widget_set_hexpand(widget, TRUE);
+    gtk_label_set_mnemonic_widget(GTK_LABEL(label), widget);
+    g_signal_connect(widget, "activate", G_CALLBACK(alarms_entry_activate_cb), axisclock);
+    g_signal_connect(widget, "focus-out-event", G_CALLBACK(alarms_entry_focus_out_cb), axisclock);
+    gtk_grid_attach(GTK_GRID(alarms_grid), widget, 1, row, 1, 1);
+    row++;
+    
+    /* Countdown length */
+    label = gtk_label_new_with_mnemonic("T_imer length (minutes):");
+    gtk_widget_set_halign(label, GTK_ALIGN_START);
+    gtk_grid_attach(GTK_GRID(alarms_grid), label, 0, row, 1, 1);
+    
+    widget = gtk_spin_button_new_with_range(1, 24 * 60, 1);
+    gtk_spin_button_set_value(GTK_SPIN_BUTTON(widget), axisclock->config->timer_minutes);
+    gtk_label_set_mnemonic_widget(GTK_LABEL(label), widget);
+    g_signal_connect(widget, "value-changed", G_CALLBACK(timer_minutes_changed_cb), axisclock);
+    gtk_grid_attach(GTK_GRID(alarms_grid), widget, 1, row, 1, 1);
+    row++;
+    
     /* Font Settings Frame */
     frame = gtk_frame_new("Font");
     gtk_box_pack_start(GTK_BOX(vbox), frame, FALSE, FALSE, 0);
@@ -302,6 +772,90 @@ axisclock_preferences_dialog_show(AxisClockPlugin *axisclock)
     gtk_widget_set_halign(label, GTK_ALIGN_START);
     gtk_style_context_add_class(gtk_widget_get_style_context(label), "dim-label");
     gtk_grid_attach(GTK_GRID(calendar_grid), label, 0, row, 2, 1);
+    row++;
+    
+    /* Event files */
+    label = gtk_label_new_with_mnemonic("_Event files:");
+    gtk_widget_set_halign(label, GTK_ALIGN_START);
+    gtk_grid_attach(GTK_GRID(calendar_grid), label, 0, row, 1, 1);
+    
+    widget = gtk_entry_new();
+    ics_text = g_strjoinv(", ", axisclock->config->ics_files);
+    gtk_entry_set_text(GTK_ENTRY(widget), ics_text);
+    g_free(ics_text);
+    gtk_entry_set_placeholder_text(GTK_ENTRY(widget), "~/.local/share/calendars/personal.ics");
+    gtk_widget_set_hexpand(widget, TRUE);
+    gtk_label_set_mnemonic_widget(GTK_LABEL(label), widget);
+    g_signal_connect(widget, "activate", G_CALLBACK(ics_entry_activate_cb), axisclock);
+    g_signal_connect(widget, "focus-out-event", G_CALLBACK(ics_entry_focus_out_cb), axisclock);
+    gtk_grid_attach(GTK_GRID(calendar_grid), widget, 1, row, 1, 1);
+    row++;
+    
+    /* ISO week numbers */
+    widget = gtk_check_button_new_with_mnemonic("Show ISO _week numbers");
+    gtk_toggle_button_set_active(GTK_TOGGLE_BUTTON(widget), axisclock->config->show_week_numbers);
+    g_signal_connect(widget, "toggled", G_CALLBACK(show_week_numbers_toggled_cb), axisclock);
+    gtk_grid_attach(GTK_GRID(calendar_grid), widget, 0, row, 2, 1);
+    row++;
+    
+    /* Public holidays */
+    label = gtk_label_new_with_mnemonic("_Holidays:");
+    gtk_widget_set_halign(label, GTK_ALIGN_START);
+    gtk_grid_attach(GTK_GRID(calendar_grid), label, 0, row, 1, 1);
+    
+    widget = gtk_combo_box_text_new();
+    gtk_combo_box_text_append(GTK_COMBO_BOX_TEXT(widget), "", "None");
+    for (guint i = 0; axisclock_holidays_country_code(i) != NULL; i++)
+        gtk_combo_box_text_append(GTK_COMBO_BOX_TEXT(widget), axisclock_holidays_country_code(i),
+                                  axisclock_holidays_country_name(i));
+    if (!gtk_combo_box_set_active_id(GTK_COMBO_BOX(widget), axisclock->config->holiday_country))
+        gtk_combo_box_set_active(GTK_COMBO_BOX(widget), 0);
+    gtk_label_set_mnemonic_widget(GTK_LABEL(label), widget);
+    g_signal_connect(widget, "changed", G_CALLBACK(holiday_country_changed_cb), axisclock);
+    gtk_grid_attach(GTK_GRID(calendar_grid), widget, 1, row, 1, 1);
+    row++;
+    
+    /* Dates in another calendar system */
+    label = gtk_label_new_with_mnemonic("Seco_ndary calendar:");
+    gtk_widget_set_halign(label, GTK_ALIGN_START);
+    gtk_grid_attach(GTK_GRID(calendar_grid), label, 0, row, 1, 1);
+    
+    widget = gtk_combo_box_text_new();
+    for (gint i = 0; i < AXISCLOCK_N_CALENDAR_SYSTEMS; i++)
+        gtk_combo_box_text_append_text(GTK_COMBO_BOX_TEXT(widget), axisclock_calendar_system_name(i));
+    gtk_combo_box_set_active(GTK_COMBO_BOX(widget), axisclock->config->secondary_calendar);
+    gtk_label_set_mnemonic_widget(GTK_LABEL(label), widget);
+    g_signal_connect(widget, "changed", G_CALLBACK(secondary_calendar_changed_cb), axisclock);
+    gtk_grid_attach(GTK_GRID(calendar_grid), widget, 1, row, 1, 1);
+    row++;
+    
+    /* Sunrise, sunset and moon phases */
+    widget = gtk_check_button_new_with_mnemonic("Show sunrise, sunset and _moon phases");
+    gtk_toggle_button_set_active(GTK_TOGGLE_BUTTON(widget), axisclock->config->show_astronomy);
+    gtk_grid_attach(GTK_GRID(calendar_grid), widget, 0, row, 2, 1);
+    row++;
+    
+    location_box = gtk_box_new(GTK_ORIENTATION_HORIZONTAL, 6);
+    gtk_widget_set_sensitive(location_box, axisclock->config->show_astronomy);
+    gtk_grid_attach(GTK_GRID(calendar_grid), location_box, 0, row, 2, 1);
+    g_object_set_data(G_OBJECT(widget), "location-box", location_box);
+    g_signal_connect(widget, "toggled", G_CALLBACK(show_astronomy_toggled_cb), axisclock);
+    
+    label = gtk_label_new_with_mnemonic("_Latitude:");
+    gtk_box_pack_start(GTK_BOX(location_box), label, FALSE, FALSE, 0);
+    widget = gtk_spin_button_new_with_range(-90.0, 90.0, 0.01);
+    gtk_spin_button_set_value(GTK_SPIN_BUTTON(widget), axisclock->config->latitude);
+    gtk_label_set_mnemonic_widget(GTK_LABEL(label), widget);
+    g_signal_connect(widget, "value-changed", G_CALLBACK(latitude_changed_cb), axisclock);
+    gtk_box_pack_start(GTK_BOX(location_box), widget, FALSE, FALSE, 0);
+    
+    label = gtk_label_new_with_mnemonic("L_ongitude:");
+    gtk_box_pack_start(GTK_BOX(location_box), label, FALSE, FALSE, 0);
+    widget = gtk_spin_button_new_with_range(-180.0, 180.0, 0.01);
+    gtk_spin_button_set_value(GTK_SPIN_BUTTON(widget), axisclock->config->longitude);
+    gtk_label_set_mnemonic_widget(GTK_LABEL(label), widget);
+    g_signal_connect(widget, "value-changed", G_CALLBACK(longitude_changed_cb), axisclock);
+    gtk_box_pack_start(GTK_BOX(location_box), widget, FALSE, FALSE, 0);
     
     /* Connect response signal */
     g_signal_connect(dialog, "response", G_CALLBACK(dialog_response_cb), axisclock);
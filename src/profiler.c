@@ -0,0 +1,231 @@
+/*
+ * xfce4-axisclock-plugin - A macOS-style clock plugin for the Xfce panel
+ *
+ * Copyright (c) 2025 Kamil 'Novik' Nowicki <novik@axisos.org>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Website: https://axisos.org
+ * Repository: https://github.com/AxisOS/xfce4-axisclock-plugin
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#ifdef AXISCLOCK_ENABLE_PROFILING
+
+#include <glib.h>
+#include <glib-unix.h>
+#include <signal.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#ifdef HAVE_SYSPROF
+#include <sysprof-capture.h>
+#endif
+
+#include "profiler.h"
+
+/* Number of recent durations kept per probe for percentiles */
+#define PROFILER_SAMPLES 512
+
+typedef struct {
+    guint64 count;
+    gint64  total_ns;
+    gint64  max_ns;
+    gint64  samples[PROFILER_SAMPLES];
+    guint   next_sample;
+} ProbeStats;
+
+static const gchar *probe_names[AXISCLOCK_N_PROBES] = {
+    "update-time",
+    "format",
+    "update-calendar",
+    "draw",
+    "calendar-show",
+    "popup-latency",
+    "astro",
+    "glyph-draw",
+    "secondary-calendar"
+};
+
+static const gchar *counter_names[AXISCLOCK_N_COUNTERS] = {
+    "ticks",
+    "label-updates",
+    "label-skipped",
+    "renders",
+    "glyph-cells",
+    "wakeups-saved",
+    "style-notifications",
+    "style-rebuilds",
+    "data-cache-hits",
+    "data-cache-misses"
+};
+
+static ProbeStats probes[AXISCLOCK_N_PROBES];
+static guint64    counters[AXISCLOCK_N_COUNTERS];
+static guint      profiler_refcount = 0;
+static guint      dump_signal_id = 0;
+
+/* SIGUSR1 handler, runs in the main loop */
+static gboolean
+profiler_dump_signal_cb(gpointer data G_GNUC_UNUSED)
+{
+    axisclock_profiler_dump();
+    return G_SOURCE_CONTINUE;
+}
+
+/* Install the dump handler; refcounted across plugin instances */
+void
+axisclock_profiler_init(void)
+{
+    if (profiler_refcount++ == 0)
+        dump_signal_id = g_unix_signal_add(SIGUSR1, profiler_dump_signal_cb, NULL);
+}
+
+/* Drop one reference and remove the dump handler with the last one */
+void
+axisclock_profiler_shutdown(void)
+{
+    g_return_if_fail(profiler_refcount > 0);
+    
+    if (--profiler_refcount == 0 && dump_signal_id != 0) {
+        g_source_remove(dump_signal_id);
+        dump_signal_id = 0;
+    }
+}
+
+/* Monotonic nanoseconds, the same time base Sysprof uses */
+gint64
+axisclock_profiler_now(void)
+{
+    struct timespec ts;
+    
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (gint64)ts.tv_sec * G_GINT64_CONSTANT(1000000000) + ts.tv_nsec;
+}
+
+/* Close a probe opened at @begin */
+void
+axisclock_profiler_record(AxisClockProbe probe, gint64 begin)
+{
+    ProbeStats *stats;
+    gint64 duration;
+    
+    g_return_if_fail(probe < AXISCLOCK_N_PROBES);
+    
+    duration = axisclock_profiler_now() - begin;
+    stats = &probes[probe];
+    
+    stats->count++;
+    stats->total_ns += duration;
+    if (duration > stats->max_ns)
+        stats->max_ns = duration;
+    stats->samples[stats->next_sample] = duration;
+    stats->next_sample = (stats->next_sample + 1) % PROFILER_SAMPLES;
+    
+#ifdef HAVE_SYSPROF
+    if (sysprof_collector_is_active())
+        sysprof_collector_mark(begin, duration, "AxisClock", probe_names[probe], NULL);
+#endif
+}
+
+/* Bump a plain counter */
+void
+axisclock_profiler_count(AxisClockCounter counter)
+{
+    g_return_if_fail(counter < AXISCLOCK_N_COUNTERS);
+    
+    counters[counter]++;
+}
+
+/* Add @n to a plain counter */
+void
+axisclock_profiler_count_n(AxisClockCounter counter, guint64 n)
+{
+    g_return_if_fail(counter < AXISCLOCK_N_COUNTERS);
+    
+    counters[counter] += n;
+}
+
+static gint
+compare_gint64(gconstpointer a, gconstpointer b)
+{
+    gint64 va = *(const gint64 *)a;
+    gint64 vb = *(const gint64 *)b;
+    
+    return (va > vb) - (va < vb);
+}
+
+/* Nearest-rank percentile of a sorted sample array, in microseconds */
+static gdouble
+percentile_us(const gint64 *sorted, guint n, guint pct)
+{
+    guint rank;
+    
+    if (n == 0)
+        return 0.0;
+    
+    rank = (n * pct + 99) / 100;
+    if (rank > 0)
+        rank--;
+    return sorted[MIN(rank, n - 1)] / 1000.0;
+}
+
+/* Format all counters and probe statistics as a human-readable report */
+gchar *
+axisclock_profiler_dump_to_string(void)
+{
+    GString *out = g_string_new("AxisClock counters\n");
+    gint64 sorted[PROFILER_SAMPLES];
+    
+    for (guint i = 0; i < AXISCLOCK_N_COUNTERS; i++)
+        g_string_append_printf(out, "  %-16s %" G_GUINT64_FORMAT "\n",
+                               counter_names[i], counters[i]);
+    
+    g_string_append(out, "AxisClock probes (us: mean p50 p90 p99 max)\n");
+    for (guint i = 0; i < AXISCLOCK_N_PROBES; i++) {
+        const ProbeStats *stats = &probes[i];
+        guint n = (guint)MIN(stats->count, (guint64)PROFILER_SAMPLES);
+        
+        memcpy(sorted, stats->samples, n * sizeof(gint64));
+        qsort(sorted, n, sizeof(gint64), compare_gint64);
+        
+        g_string_append_printf(out,
+                               "  %-16s n=%-8" G_GUINT64_FORMAT " %.1f %.1f %.1f %.1f %.1f\n",
+                               probe_names[i], stats->count,
+                               stats->count ? stats->total_ns / 1000.0 / stats->count : 0.0,
+                               percentile_us(sorted, n, 50),
+                               percentile_us(sorted, n, 90),
+                               percentile_us(sorted, n, 99),
+                               stats->max_ns / 1000.0);
+    }
+    
+    return g_string_free(out, FALSE);
+}
+
+/* Write the report to the log */
+void
+axisclock_profiler_dump(void)
+{
+    gchar *report = axisclock_profiler_dump_to_string();
+    
+    g_message("%s", report);
+    g_free(report);
+}
+
+#endif /* AXISCLOCK_ENABLE_PROFILING */
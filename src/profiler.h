@@ -0,0 +1,98 @@
+/*
+ * xfce4-axisclock-plugin - A macOS-style clock plugin for the Xfce panel
+ *
+ * Copyright (c) 2025 Kamil 'Novik' Nowicki <novik@axisos.org>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Website: https://axisos.org
+ * Repository: https://github.com/AxisOS/xfce4-axisclock-plugin
+ */
+
+#ifndef __PROFILER_H__
+#define __PROFILER_H__
+
+#include <glib.h>
+
+G_BEGIN_DECLS
+
+/* Timed hot paths */
+typedef enum {
+    AXISCLOCK_PROBE_UPDATE_TIME,
+    AXISCLOCK_PROBE_FORMAT,
+    AXISCLOCK_PROBE_UPDATE_CALENDAR,
+    AXISCLOCK_PROBE_DRAW,
+    AXISCLOCK_PROBE_CALENDAR_SHOW,
+    AXISCLOCK_PROBE_POPUP_LATENCY,      /* calendar_show() to first draw */
+    AXISCLOCK_PROBE_ASTRO,              /* One calendar page of sun and moon data */
+    AXISCLOCK_PROBE_GLYPH_DRAW,         /* Atlas blits of the panel clock */
+    AXISCLOCK_PROBE_SECONDARY_CALENDAR, /* One calendar page in another calendar system */
+    AXISCLOCK_N_PROBES
+} AxisClockProbe;
+
+/* Plain event counters */
+typedef enum {
+    AXISCLOCK_COUNTER_TICKS,
+    AXISCLOCK_COUNTER_LABEL_UPDATES,
+    AXISCLOCK_COUNTER_LABEL_SKIPPED,
+    AXISCLOCK_COUNTER_RENDERS,
+    AXISCLOCK_COUNTER_GLYPH_CELLS,      /* Atlas cells invalidated */
+    AXISCLOCK_COUNTER_WAKEUPS_SAVED,    /* Ticks skipped by the battery policy */
+    AXISCLOCK_COUNTER_STYLE_NOTIFICATIONS, /* Style, screen and scale changes seen */
+    AXISCLOCK_COUNTER_STYLE_REBUILDS,   /* Coalesced cache rebuilds they caused */
+    AXISCLOCK_COUNTER_DATA_CACHE_HITS,  /* Entries mapped from the shared data cache */
+    AXISCLOCK_COUNTER_DATA_CACHE_MISSES, /* Entries that had to be built */
+    AXISCLOCK_N_COUNTERS
+} AxisClockCounter;
+
+/*
+ * The instrumentation is compiled in only with -Dprofiling=true. Otherwise
+ * every macro below expands to nothing, so the hot paths carry no cost.
+ * A running instance dumps its counters to the log on SIGUSR1.
+ */
+#ifdef AXISCLOCK_ENABLE_PROFILING
+
+void    axisclock_profiler_init           (void);
+void    axisclock_profiler_shutdown       (void);
+gint64  axisclock_profiler_now            (void);
+void    axisclock_profiler_record         (AxisClockProbe   probe,
+                                           gint64           begin);
+void    axisclock_profiler_count          (AxisClockCounter counter);
+void    axisclock_profiler_count_n        (AxisClockCounter counter,
+                                           guint64          n);
+gchar  *axisclock_profiler_dump_to_string (void);
+void    axisclock_profiler_dump           (void);
+
+#define AXISCLOCK_PROBE_BEGIN(var)          gint64 var = axisclock_profiler_now()
+#define AXISCLOCK_PROBE_END(probe, var)     axisclock_profiler_record((probe), (var))
+#define AXISCLOCK_PROBE_STAMP(lvalue)       ((lvalue) = axisclock_profiler_now())
+#define AXISCLOCK_COUNT(counter)            axisclock_profiler_count(counter)
+#define AXISCLOCK_COUNT_N(counter, n)       axisclock_profiler_count_n((counter), (n))
+
+#else /* !AXISCLOCK_ENABLE_PROFILING */
+
+#define axisclock_profiler_init()           G_STMT_START { } G_STMT_END
+#define axisclock_profiler_shutdown()       G_STMT_START { } G_STMT_END
+#define AXISCLOCK_PROBE_BEGIN(var)          G_STMT_START { } G_STMT_END
+#define AXISCLOCK_PROBE_END(probe, var)     G_STMT_START { } G_STMT_END
+#define AXISCLOCK_PROBE_STAMP(lvalue)       G_STMT_START { } G_STMT_END
+#define AXISCLOCK_COUNT(counter)            G_STMT_START { } G_STMT_END
+#define AXISCLOCK_COUNT_N(counter, n)       G_STMT_START { } G_STMT_END
+
+#endif /* AXISCLOCK_ENABLE_PROFILING */
+
+G_END_DECLS
+
+#endif /* !__PROFILER_H__ */
@@ -0,0 +1,509 @@
+/*
+ * xfce4-axisclock-plugin - A macOS-style clock plugin for the Xfce panel
+ *
+ * Copyright (c) 2025 Kamil 'Novik' Nowicki <novik@axisos.org>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Website: https://axisos.org
+ * Repository: https://github.com/AxisOS/xfce4-axisclock-plugin
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <glib.h>
+#include <glib-unix.h>
+#include <errno.h>
+#include <time.h>
+#include <unistd.h>
+
+#ifdef HAVE_TIMERFD
+#include <sys/timerfd.h>
+#endif
+
+#include "tick_service.h"
+#include "time_formatter.h"
+#include "profiler.h"
+
+struct _AxisClockTickSubscription {
+    guint             granularity;  /* Seconds between calls */
+    gint64            last_slot;    /* Boundary index of the last call */
+    AxisClockTickFunc func;
+    gpointer          user_data;
+};
+
+/* A zone table shared by every instance showing that zone */
+typedef struct {
+    AxisClockZone *zone;
+    guint          refcount;
+    guint64        serial;          /* Tick @time_info was computed for */
+    struct tm      time_info;
+} SharedZone;
+
+typedef struct {
+    guint          refcount;
+    GList         *subscriptions;
+    GHashTable    *zones;           /* identifier -> SharedZone */
+    GHashTable    *rendered;        /* "zone\nformat" -> text of this tick */
+    guint64        rendered_serial;
+    AxisClockTick  tick;
+    gint           fd;              /* Wall-clock timerfd, -1 when unavailable */
+    guint          fd_source_id;
+    guint          timeout_id;      /* Fallback when there is no timerfd */
+    gboolean       armed;
+    guint          granularity;
+    gint64         next_boundary;   /* UTC milliseconds */
+} TickService;
+
+static TickService *service = NULL;
+
+static void tick_service_schedule(void);
+static void tick_service_open_timer(void);
+
+static void
+shared_zone_free(gpointer data)
+{
+    SharedZone *shared = data;
+    
+    axisclock_zone_free(shared->zone);
+    g_free(shared);
+}
+
+/* Read the clock once for everybody */
+static void
+tick_service_read_clock(void)
+{
+    time_t now = (time_t)(g_get_real_time() / G_USEC_PER_SEC);
+    
+    service->tick.now = now;
+    localtime_r(&now, &service->tick.local_time);
+    service->tick.serial++;
+}
+
+static void
+tick_service_ref(void)
+{
+    if (service == NULL) {
+        service = g_new0(TickService, 1);
+        service->zones = g_hash_table_new_full(g_str_hash, g_str_equal, NULL, shared_zone_free);
+        service->rendered = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, g_free);
+        service->fd = -1;
+        tick_service_read_clock();
+        tick_service_open_timer();
+    }
+    
+    service->refcount++;
+}
+
+static void
+tick_service_unref(void)
+{
+    g_return_if_fail(service != NULL && service->refcount > 0);
+    
+    if (--service->refcount > 0)
+        return;
+    
+    if (service->timeout_id != 0)
+        g_source_remove(service->timeout_id);
+    if (service->fd_source_id != 0)
+        g_source_remove(service->fd_source_id);
+    if (service->fd >= 0)
+        close(service->fd);
+    g_hash_table_destroy(service->zones);
+    g_hash_table_destroy(service->rendered);
+    g_list_free(service->subscriptions);
+    g_clear_pointer(&service, g_free);
+}
+
+/* Boundary index of @now for @granularity, in local time */
+static gint64
+tick_service_slot(const AxisClockTick *tick, guint granularity)
+{
+    return (tick->now + tick->local_time.tm_gmtoff) / MAX(granularity, 1);
+}
+
+/* Call every subscriber whose own boundary was crossed */
+static void
+tick_service_dispatch(void)
+{
+    GList *l, *next;
+    
+    for (l = service->subscriptions; l != NULL; l = next) {
+        AxisClockTickSubscription *subscription = l->data;
+        gint64 slot = tick_service_slot(&service->tick, subscription->granularity);
+        
+        /* Saved first: the callback may unsubscribe itself */
+        next = l->next;
+        
+        if (slot != subscription->last_slot) {
+            subscription->last_slot = slot;
+            subscription->func(&service->tick, subscription->user_data);
+        }
+    }
+}
+
+/* Read the clock, call the subscribers and arm the next boundary */
+static void
+tick_service_fire(void)
+{
+    AXISCLOCK_COUNT(AXISCLOCK_COUNTER_TICKS);
+    
+    /* Keep the service alive while subscribers run */
+    tick_service_ref();
+    service->armed = FALSE;
+    tick_service_read_clock();
+    tick_service_dispatch();
+    
+    if (!service->armed && service->subscriptions != NULL)
+        tick_service_schedule();
+    tick_service_unref();
+}
+
+static gboolean
+tick_service_timeout(gpointer data G_GNUC_UNUSED)
+{
+    service->timeout_id = 0;
+    tick_service_fire();
+    
+    return G_SOURCE_REMOVE;
+}
+
+#ifdef HAVE_TIMERFD
+static gboolean
+tick_service_fd_cb(gint fd, GIOCondition condition G_GNUC_UNUSED, gpointer user_data G_GNUC_UNUSED)
+{
+    guint64 expirations;
+    
+    if (read(fd, &expirations, sizeof(expirations)) < 0) {
+        if (errno == EAGAIN)
+            return G_SOURCE_CONTINUE;
+        /* ECANCELED: the wall clock was set (resume, NTP, by hand), which
+         * may also come with a new zone */
+        if (errno == ECANCELED)
+            tzset();
+        else
+            g_warning("Cannot read tick timer: %s", g_strerror(errno));
+    }
+    
+    tick_service_fire();
+    return G_SOURCE_CONTINUE;
+}
+#endif
+
+/* Boundaries follow the wall clock, so prefer a timer that notices when it is set */
+static void
+tick_service_open_timer(void)
+{
+#ifdef HAVE_TIMERFD
+    service->fd = timerfd_create(CLOCK_REALTIME, TFD_NONBLOCK | TFD_CLOEXEC);
+    if (service->fd >= 0)
+        service->fd_source_id = g_unix_fd_add(service->fd, G_IO_IN, tick_service_fd_cb, NULL);
+    else
+        g_warning("Cannot create tick timer: %s", g_strerror(errno));
+#endif
+}
+
+/* Arm one timeout for the next local boundary of the finest granularity */
+static void
+tick_service_schedule(void)
+{
+    gint64 now_ms, local_ms, period_ms, delay_ms = 0;
+    
+    if (service->timeout_id != 0) {
+        g_source_remove(service->timeout_id);
+        service->timeout_id = 0;
+    }
+    
+    service->armed = service->subscriptions != NULL;
+    
+    if (service->armed) {
+        now_ms = g_get_real_time() / 1000;
+        local_ms = now_ms + (gint64)service->tick.local_time.tm_gmtoff * 1000;
+        period_ms = (gint64)MAX(service->granularity, 1) * 1000;
+        delay_ms = period_ms - local_ms % period_ms;
+        service->next_boundary = now_ms + delay_ms;
+    }
+    
+#ifdef HAVE_TIMERFD
+    if (service->fd >= 0) {
+        struct itimerspec spec = { { 0, 0 }, { 0, 0 } };
+        
+        if (service->armed) {
+            gint64 when_ms = service->next_boundary + AXISCLOCK_BOUNDARY_SLACK_MS;
+            
+            spec.it_value.tv_sec = when_ms / 1000;
+            spec.it_value.tv_nsec = (when_ms % 1000) * 1000000;
+        }
+        
+        /* Also re-arms the cancel-on-set watch for the next clock change */
+        if (timerfd_settime(service->fd, TFD_TIMER_ABSTIME | TFD_TIMER_CANCEL_ON_SET, &spec, NULL) < 0)
+            g_warning("Cannot arm tick timer: %s", g_strerror(errno));
+        return;
+    }
+#endif
+    
+    /* Fallback: a one-shot timeout, which misses wall-clock changes
+     * until it fires */
+    if (service->armed)
+        service->timeout_id = g_timeout_add((guint)delay_ms + AXISCLOCK_BOUNDARY_SLACK_MS,
+                                            tick_service_timeout, NULL);
+}
+
+/* Recompute the finest granularity and re-arm if it changed */
+static void
+tick_service_update_granularity(void)
+{
+    guint granularity = G_MAXUINT;
+    
+    for (GList *l = service->subscriptions; l != NULL; l = l->next) {
+        AxisClockTickSubscription *subscription = l->data;
+        granularity = MIN(granularity, subscription->granularity);
+    }
+    
+    if (granularity != service->granularity || !service->armed) {
+        service->granularity = granularity;
+        tick_service_schedule();
+    }
+}
+
+/**
+ * axisclock_tick_service_subscribe:
+ * @granularity: Seconds between calls, aligned to local boundaries
+ * @func: Called with the shared tick at each of those boundaries
+ * @user_data: Passed to @func
+ *
+ * Subscribes to the shared tick. @func is not called immediately; use
+ * axisclock_tick_service_get_tick() for the initial render.
+ *
+ * Returns: A subscription to pass to axisclock_tick_service_unsubscribe().
+ */
+AxisClockTickSubscription *
+axisclock_tick_service_subscribe(guint granularity, AxisClockTickFunc func, gpointer user_data)
+{
+    AxisClockTickSubscription *subscription;
+    
+    g_return_val_if_fail(func != NULL, NULL);
+    
+    tick_service_ref();
+    
+    subscription = g_new0(AxisClockTickSubscription, 1);
+    subscription->granularity = MAX(granularity, 1);
+    subscription->func = func;
+    subscription->user_data = user_data;
+    subscription->last_slot = tick_service_slot(&service->tick, subscription->granularity);
+    
+    service->subscriptions = g_list_append(service->subscriptions, subscription);
+    tick_service_update_granularity();
+    
+    return subscription;
+}
+
+/**
+ * axisclock_tick_service_unsubscribe:
+ * @subscription: A subscription
+ *
+ * Stops calling @subscription and releases its reference on the service.
+ */
+void
+axisclock_tick_service_unsubscribe(AxisClockTickSubscription *subscription)
+{
+    g_return_if_fail(service != NULL && subscription != NULL);
+    
+    service->subscriptions = g_list_remove(service->subscriptions, subscription);
+    g_free(subscription);
+    
+    tick_service_update_granularity();
+    tick_service_unref();
+}
+
+/**
+ * axisclock_tick_service_set_granularity:
+ * @subscription: A subscription
+ * @granularity: New number of seconds between calls
+ *
+ * Changes how often @subscription is called; the shared timer follows the
+ * finest granularity of all subscriptions.
+ */
+void
+axisclock_tick_service_set_granularity(AxisClockTickSubscription *subscription, guint granularity)
+{
+    g_return_if_fail(service != NULL && subscription != NULL);
+    
+    granularity = MAX(granularity, 1);
+    if (subscription->granularity == granularity)
+        return;
+    
+    subscription->granularity = granularity;
+    subscription->last_slot = tick_service_slot(&service->tick, granularity);
+    tick_service_update_granularity();
+}
+
+/**
+ * axisclock_tick_service_get_tick:
+ *
+ * Returns the current shared tick, reading the clock again only when the
+ * second changed since the last read.
+ *
+ * Returns: The shared tick, owned by the service.
+ */
+const AxisClockTick *
+axisclock_tick_service_get_tick(void)
+{
+    g_return_val_if_fail(service != NULL, NULL);
+    
+    if (g_get_real_time() / G_USEC_PER_SEC != service->tick.now)
+        tick_service_read_clock();
+    
+    return &service->tick;
+}
+
+/**
+ * axisclock_tick_service_get_next_boundary:
+ *
+ * Returns: UTC seconds of the next scheduled tick, or 0 if none is armed.
+ */
+gint64
+axisclock_tick_service_get_next_boundary(void)
+{
+    if (service == NULL || !service->armed)
+        return 0;
+    
+    return service->next_boundary / 1000;
+}
+
+/**
+ * axisclock_tick_service_ref_zone:
+ * @identifier: Olson time zone identifier
+ *
+ * Returns the process-wide table for @identifier, building it on first use.
+ *
+ * Returns: The shared zone, or %NULL if it is unknown. Release it with
+ * axisclock_tick_service_unref_zone().
+ */
+AxisClockZone *
+axisclock_tick_service_ref_zone(const gchar *identifier)
+{
+    SharedZone *shared;
+    
+    g_return_val_if_fail(identifier != NULL, NULL);
+    
+    tick_service_ref();
+    
+    shared = g_hash_table_lookup(service->zones, identifier);
+    if (shared == NULL) {
+        AxisClockZone *zone = axisclock_zone_new(identifier);
+        
+        if (zone == NULL) {
+            tick_service_unref();
+            return NULL;
+        }
+        
+        shared = g_new0(SharedZone, 1);
+        shared->zone = zone;
+        g_hash_table_insert(service->zones, zone->identifier, shared);
+    }
+    
+    shared->refcount++;
+    return shared->zone;
+}
+
+/**
+ * axisclock_tick_service_unref_zone:
+ * @zone: A zone returned by axisclock_tick_service_ref_zone()
+ *
+ * Releases a shared zone; the table is freed with its last user.
+ */
+void
+axisclock_tick_service_unref_zone(AxisClockZone *zone)
+{
+    SharedZone *shared;
+    
+    g_return_if_fail(service != NULL && zone != NULL);
+    
+    shared = g_hash_table_lookup(service->zones, zone->identifier);
+    g_return_if_fail(shared != NULL);
+    
+    if (--shared->refcount == 0)
+        g_hash_table_remove(service->zones, zone->identifier);
+    
+    tick_service_unref();
+}
+
+/**
+ * axisclock_tick_get_zone_time:
+ * @tick: The shared tick
+ * @zone: A shared zone
+ *
+ * Returns: @tick broken down in @zone, computed once per tick.
+ */
+const struct tm *
+axisclock_tick_get_zone_time(const AxisClockTick *tick, AxisClockZone *zone)
+{
+    SharedZone *shared;
+    
+    g_return_val_if_fail(service != NULL && tick != NULL && zone != NULL, NULL);
+    
+    shared = g_hash_table_lookup(service->zones, zone->identifier);
+    g_return_val_if_fail(shared != NULL, NULL);
+    
+    if (shared->serial != tick->serial) {
+        axisclock_zone_localtime(zone, tick->now, &shared->time_info);
+        shared->serial = tick->serial;
+    }
+    
+    return &shared->time_info;
+}
+
+/**
+ * axisclock_tick_format:
+ * @tick: The shared tick
+ * @zone: A shared zone, or %NULL for the local zone
+ * @format: strftime format
+ *
+ * Formats @tick, sharing the result between all instances asking for the
+ * same zone and format during this tick.
+ *
+ * Returns: The rendered text, owned by the service and valid until the next
+ * clock read.
+ */
+const gchar *
+axisclock_tick_format(const AxisClockTick *tick, AxisClockZone *zone, const gchar *format)
+{
+    gchar *key;
+    gchar *text;
+    
+    g_return_val_if_fail(service != NULL && tick != NULL && format != NULL, NULL);
+    
+    if (service->rendered_serial != tick->serial) {
+        g_hash_table_remove_all(service->rendered);
+        service->rendered_serial = tick->serial;
+    }
+    
+    key = g_strconcat(zone != NULL ? zone->identifier : "", "\n", format, NULL);
+    text = g_hash_table_lookup(service->rendered, key);
+    
+    if (text != NULL) {
+        g_free(key);
+        return text;
+    }
+    
+    text = axisclock_format_time(format, zone != NULL ? axisclock_tick_get_zone_time(tick, zone)
+                                                      : &tick->local_time);
+    g_hash_table_insert(service->rendered, key, text);
+    
+    return text;
+}
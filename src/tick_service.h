@@ -0,0 +1,83 @@
+/*
+ * xfce4-axisclock-plugin - A macOS-style clock plugin for the Xfce panel
+ *
+ * Copyright (c) 2025 Kamil 'Novik' Nowicki <novik@axisos.org>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Website: https://axisos.org
+ * Repository: https://github.com/AxisOS/xfce4-axisclock-plugin
+ */
+
+#ifndef __TICK_SERVICE_H__
+#define __TICK_SERVICE_H__
+
+#include <glib.h>
+#include <time.h>
+#include "zone_table.h"
+
+G_BEGIN_DECLS
+
+/* Delay past each boundary so the update never lands just before it */
+#define AXISCLOCK_BOUNDARY_SLACK_MS 2
+
+/**
+ * AxisClockTick:
+ * @now: UTC seconds of the clock read
+ * @local_time: @now broken down in the local zone
+ * @serial: Increments with every clock read
+ *
+ * One clock read, shared by every subscriber in the process.
+ */
+typedef struct _AxisClockTick {
+    gint64    now;
+    struct tm local_time;
+    guint64   serial;
+} AxisClockTick;
+
+typedef struct _AxisClockTickSubscription AxisClockTickSubscription;
+
+typedef void (*AxisClockTickFunc) (const AxisClockTick *tick,
+                                   gpointer             user_data);
+
+/*
+ * The service is a process-wide singleton created by the first subscription
+ * or zone reference and destroyed with the last one. It runs a single
+ * timeout at the finest granularity any subscriber asked for, aligned to
+ * local boundaries, and calls each subscriber only on its own boundaries.
+ */
+AxisClockTickSubscription *axisclock_tick_service_subscribe       (guint                      granularity,
+                                                                   AxisClockTickFunc          func,
+                                                                   gpointer                   user_data);
+void                       axisclock_tick_service_unsubscribe     (AxisClockTickSubscription *subscription);
+void                       axisclock_tick_service_set_granularity (AxisClockTickSubscription *subscription,
+                                                                   guint                      granularity);
+const AxisClockTick       *axisclock_tick_service_get_tick        (void);
+gint64                     axisclock_tick_service_get_next_boundary (void);
+
+/* Zone tables shared by identifier across instances */
+AxisClockZone             *axisclock_tick_service_ref_zone        (const gchar               *identifier);
+void                       axisclock_tick_service_unref_zone      (AxisClockZone             *zone);
+const struct tm           *axisclock_tick_get_zone_time           (const AxisClockTick       *tick,
+                                                                   AxisClockZone             *zone);
+
+/* Rendered text shared by (zone, format) for the duration of one tick */
+const gchar               *axisclock_tick_format                  (const AxisClockTick       *tick,
+                                                                   AxisClockZone             *zone,
+                                                                   const gchar               *format);
+
+G_END_DECLS
+
+#endif /* !__TICK_SERVICE_H__ */
@@ -28,51 +28,496 @@
 #include <glib.h>
 #include <time.h>
 #include <string.h>
-#include <ctype.h>
 
 #include "time_formatter.h"
 #include "plugin_config.h"
+#include "locale_cache.h"
+#include "profiler.h"
 
 /* Get the current time formatted according to configuration */
 gchar *
 axisclock_get_formatted_time(PluginConfig *config)
 {
     time_t current_time;
-    struct tm *time_info;
-    gchar buffer[256];
-    gchar *formatted_time;
-    gchar *p;
+    struct tm time_info;
     const gchar *format;
     
     /* Get current time */
     time(&current_time);
-    time_info = localtime(&current_time);
+    localtime_r(&current_time, &time_info);
+    
+    /* Fuzzy phrases are prebuilt, no formatting needed */
+    if (config && config->display_mode == PLUGIN_DISPLAY_MODE_FUZZY)
+        return g_strdup(axisclock_format_fuzzy(&time_info, config->fuzzy_minutes));
     
     /* Use configured format or default */
     format = (config && config->time_format) ? config->time_format : AXISCLOCK_TIME_FORMAT;
     
-    /* Format time string */
-    strftime(buffer, sizeof(buffer), format, time_info);
+    return axisclock_format_time(format, &time_info);
+}
+
+/* Kinds of compiled format tokens */
+typedef enum {
+    TOKEN_LITERAL,
+    TOKEN_ABDAY,
+    TOKEN_DAY,
+    TOKEN_ABMON,
+    TOKEN_MON,
+    TOKEN_AMPM,
+    TOKEN_HOUR24,
+    TOKEN_HOUR12,
+    TOKEN_MINUTE,
+    TOKEN_SECOND,
+    TOKEN_MDAY,
+    TOKEN_MONTH,
+    TOKEN_YEAR,
+    TOKEN_YEAR2,
+    TOKEN_YDAY,
+    TOKEN_STRFTIME              /* Anything else, handed to strftime() */
+} TokenKind;
+
+typedef struct {
+    TokenKind kind;
+    guint     width;            /* Minimum digits, 0 for none */
+    gchar     pad;              /* '0' or ' ' */
+    gsize     offset;           /* Literal text or strftime spec in strings */
+    gsize     length;
+} FormatToken;
+
+/* A format string parsed once into tokens */
+typedef struct {
+    GArray  *tokens;
+    GString *strings;           /* Backing store for literals and specs */
+    guint    granularity;
+    gchar   *format;            /* Source string, the cache key */
+} CompiledFormat;
+
+/* Most recently used compiled formats, newest first. The preferences
+ * entries re-render on every keystroke, so the cache is bounded rather than
+ * keeping every half-typed format alive; the configured formats stay hot. */
+#define COMPILED_FORMAT_SLOTS 16
+static CompiledFormat *compiled_formats[COMPILED_FORMAT_SLOTS];
+static guint n_compiled_formats = 0;
+
+static void
+compiled_format_free(CompiledFormat *compiled)
+{
+    g_free(compiled->format);
+    g_array_free(compiled->tokens, TRUE);
+    g_string_free(compiled->strings, TRUE);
+    g_free(compiled);
+}
+
+static void
+compiled_add_text(CompiledFormat *compiled, TokenKind kind, const gchar *text, gsize length)
+{
+    FormatToken token = { kind, 0, 0, compiled->strings->len, length };
+    
+    /* Merge consecutive literals */
+    if (kind == TOKEN_LITERAL && compiled->tokens->len > 0) {
+        FormatToken *last = &g_array_index(compiled->tokens, FormatToken, compiled->tokens->len - 1);
+        
+        if (last->kind == TOKEN_LITERAL) {
+            g_string_append_len(compiled->strings, text, length);
+            last->length += length;
+            return;
+        }
+    }
+    
+    g_string_append_len(compiled->strings, text, length);
+    g_array_append_val(compiled->tokens, token);
+}
+
+static void
+compiled_add_field(CompiledFormat *compiled, TokenKind kind, guint width, gchar pad)
+{
+    FormatToken token = { kind, width, pad, 0, 0 };
+    
+    if (kind == TOKEN_SECOND)
+        compiled->granularity = 1;
+    
+    g_array_append_val(compiled->tokens, token);
+}
+
+/* Add a numeric field honouring glibc's '-', '_' and '0' flags and width */
+static void
+compiled_add_number(CompiledFormat *compiled, TokenKind kind, guint default_width,
+                    gchar default_pad, gchar flag, guint width)
+{
+    gchar pad = default_pad;
+    
+    if (width == 0)
+        width = default_width;
+    if (flag == '-')
+        width = 0;
+    else if (flag == '_')
+        pad = ' ';
+    else if (flag == '0')
+        pad = '0';
+    
+    compiled_add_field(compiled, kind, width, pad);
+}
+
+/* Parse @format into tokens. Conversions the formatter renders itself read
+ * the locale snapshot; the rest are kept as single-conversion strftime()
+ * specs. */
+static CompiledFormat *
+compile_format(const gchar *format)
+{
+    CompiledFormat *compiled = g_new0(CompiledFormat, 1);
+    const gchar *p = format;
+    
+    compiled->tokens = g_array_new(FALSE, FALSE, sizeof(FormatToken));
+    compiled->strings = g_string_new(NULL);
+    compiled->granularity = 60;
+    compiled->format = g_strdup(format);
+    
+    while (*p != '\0') {
+        const gchar *spec = p;
+        const gchar *literal_end = strchr(p, '%');
+        gchar flag = 0;
+        guint width = 0;
+        gboolean modifier = FALSE;
+        
+        if (literal_end == NULL)
+            literal_end = p + strlen(p);
+        if (literal_end > p) {
+            compiled_add_text(compiled, TOKEN_LITERAL, p, literal_end - p);
+            p = literal_end;
+            continue;
+        }
+        
+        /* At a '%': flags, width, E/O modifier, conversion */
+        p++;
+        while (*p == '-' || *p == '_' || *p == '0' || *p == '^' || *p == '#') {
+            /* Case flags need strftime() */
+            if (*p == '^' || *p == '#')
+                modifier = TRUE;
+            flag = *p++;
+        }
+        while (g_ascii_isdigit(*p))
+            width = width * 10 + (*p++ - '0');
+        if (*p == 'E' || *p == 'O') {
+            modifier = TRUE;
+            p++;
+        }
+        
+        if (*p == '\0') {
+            compiled_add_text(compiled, TOKEN_LITERAL, spec, p - spec);
+            break;
+        }
+        
+        if (modifier) {
+            if (strchr("sSTrcX+", *p) != NULL)
+                compiled->granularity = 1;
+            compiled_add_text(compiled, TOKEN_STRFTIME, spec, p + 1 - spec);
+            p++;
+            continue;
+        }
+        
+        switch (*p) {
+            case 'a': compiled_add_field(compiled, TOKEN_ABDAY, 0, 0); break;
+            case 'A': compiled_add_field(compiled, TOKEN_DAY, 0, 0); break;
+            case 'b':
+            case 'h': compiled_add_field(compiled, TOKEN_ABMON, 0, 0); break;
+            case 'B': compiled_add_field(compiled, TOKEN_MON, 0, 0); break;
+            case 'p':
+            case 'P': compiled_add_field(compiled, TOKEN_AMPM, 0, 0); break;
+            case 'H': compiled_add_number(compiled, TOKEN_HOUR24, 2, '0', flag, width); break;
+            case 'k': compiled_add_number(compiled, TOKEN_HOUR24, 2, ' ', flag, width); break;
+            case 'I': compiled_add_number(compiled, TOKEN_HOUR12, 2, '0', flag, width); break;
+            case 'l': compiled_add_number(compiled, TOKEN_HOUR12, 2, ' ', flag, width); break;
+            case 'M': compiled_add_number(compiled, TOKEN_MINUTE, 2, '0', flag, width); break;
+            case 'S': compiled_add_number(compiled, TOKEN_SECOND, 2, '0', flag, width); break;
+            case 'd': compiled_add_number(compiled, TOKEN_MDAY, 2, '0', flag, width); break;
+            case 'e': compiled_add_number(compiled, TOKEN_MDAY, 2, ' ', flag, width); break;
+            case 'm': compiled_add_number(compiled, TOKEN_MONTH, 2, '0', flag, width); break;
+            case 'Y': compiled_add_number(compiled, TOKEN_YEAR, 0, '0', flag, width); break;
+            case 'y': compiled_add_number(compiled, TOKEN_YEAR2, 2, '0', flag, width); break;
+            case 'j': compiled_add_number(compiled, TOKEN_YDAY, 3, '0', flag, width); break;
+            case 'R':
+                compiled_add_field(compiled, TOKEN_HOUR24, 2, '0');
+                compiled_add_text(compiled, TOKEN_LITERAL, ":", 1);
+                compiled_add_field(compiled, TOKEN_MINUTE, 2, '0');
+                break;
+            case 'T':
+                compiled_add_field(compiled, TOKEN_HOUR24, 2, '0');
+                compiled_add_text(compiled, TOKEN_LITERAL, ":", 1);
+                compiled_add_field(compiled, TOKEN_MINUTE, 2, '0');
+                compiled_add_text(compiled, TOKEN_LITERAL, ":", 1);
+                compiled_add_field(compiled, TOKEN_SECOND, 2, '0');
+                break;
+            case 'n': compiled_add_text(compiled, TOKEN_LITERAL, "\n", 1); break;
+            case 't': compiled_add_text(compiled, TOKEN_LITERAL, "\t", 1); break;
+            case '%': compiled_add_text(compiled, TOKEN_LITERAL, "%", 1); break;
+            default:
+                if (strchr("srcX+", *p) != NULL)
+                    compiled->granularity = 1;
+                compiled_add_text(compiled, TOKEN_STRFTIME, spec, p + 1 - spec);
+                break;
+        }
+        p++;
+    }
+    
+    return compiled;
+}
+
+/* Look up or compile @format, evicting the least recently used entry when
+ * the cache is full. The result is valid until the next call. */
+static const CompiledFormat *
+get_compiled_format(const gchar *format)
+{
+    CompiledFormat *compiled;
+    guint i;
+    
+    for (i = 0; i < n_compiled_formats; i++) {
+        if (strcmp(compiled_formats[i]->format, format) == 0)
+            break;
+    }
+    
+    if (i < n_compiled_formats) {
+        compiled = compiled_formats[i];
+    } else {
+        compiled = compile_format(format);
+        if (n_compiled_formats == COMPILED_FORMAT_SLOTS)
+            compiled_format_free(compiled_formats[--n_compiled_formats]);
+        i = n_compiled_formats++;
+    }
+    
+    /* Move to the front */
+    memmove(&compiled_formats[1], &compiled_formats[0], i * sizeof(compiled_formats[0]));
+    compiled_formats[0] = compiled;
+    
+    return compiled;
+}
+
+/* Append @value in decimal, left-padded to @width with @pad */
+static void
+append_number(GString *out, gint value, guint width, gchar pad)
+{
+    gchar digits[16];
+    guint n = 0;
+    guint v = value < 0 ? (guint)-value : (guint)value;
+    
+    do {
+        digits[n++] = '0' + v % 10;
+        v /= 10;
+    } while (v != 0 && n < sizeof(digits));
     
-    /* Convert AM/PM to lowercase and remove space before it */
-    formatted_time = g_strdup(buffer);
+    while (n < width && n < sizeof(digits) - 1)
+        digits[n++] = pad;
+    if (value < 0)
+        g_string_append_c(out, '-');
     
-    /* Find AM or PM in the string */
-    p = strstr(formatted_time, "AM");
-    if (p == NULL) {
-        p = strstr(formatted_time, "PM");
+    while (n > 0)
+        g_string_append_c(out, digits[--n]);
+}
+
+/* Append a locale string that is already UTF-8 and measured */
+static inline void
+append_locale_string(GString *out, const AxisClockLocaleString *string)
+{
+    g_string_append_len(out, string->text, string->length);
+}
+
+/* Format an already broken-down time */
+gchar *
+axisclock_format_time(const gchar *format, const struct tm *time_info)
+{
+    const AxisClockLocale *locale;
+    const CompiledFormat *compiled;
+    GString *out;
+    
+    AXISCLOCK_PROBE_BEGIN(probe_start);
+    
+    compiled = get_compiled_format(format);
+    locale = axisclock_locale_get();
+    out = g_string_sized_new(64);
+    
+    for (guint i = 0; i < compiled->tokens->len; i++) {
+        const FormatToken *token = &g_array_index(compiled->tokens, FormatToken, i);
+        gint hour12;
+        
+        switch (token->kind) {
+            case TOKEN_LITERAL:
+                g_string_append_len(out, compiled->strings->str + token->offset, token->length);
+                break;
+            case TOKEN_ABDAY:
+                append_locale_string(out, &locale->abday[time_info->tm_wday % 7]);
+                break;
+            case TOKEN_DAY:
+                append_locale_string(out, &locale->day[time_info->tm_wday % 7]);
+                break;
+            case TOKEN_ABMON:
+                append_locale_string(out, &locale->abmon[time_info->tm_mon % 12]);
+                break;
+            case TOKEN_MON:
+                append_locale_string(out, &locale->mon[time_info->tm_mon % 12]);
+                break;
+            case TOKEN_AMPM:
+                /* Lowercase marker glued to the time, "3:45pm" */
+                if (out->len > 0 && out->str[out->len - 1] == ' ')
+                    g_string_truncate(out, out->len - 1);
+                append_locale_string(out, time_info->tm_hour < 12 ? &locale->am : &locale->pm);
+                break;
+            case TOKEN_HOUR24:
+                append_number(out, time_info->tm_hour, token->width, token->pad);
+                break;
+            case TOKEN_HOUR12:
+                hour12 = time_info->tm_hour % 12;
+                append_number(out, hour12 == 0 ? 12 : hour12, token->width, token->pad);
+                break;
+            case TOKEN_MINUTE:
+                append_number(out, time_info->tm_min, token->width, token->pad);
+                break;
+            case TOKEN_SECOND:
+                append_number(out, time_info->tm_sec, token->width, token->pad);
+                break;
+            case TOKEN_MDAY:
+                append_number(out, time_info->tm_mday, token->width, token->pad);
+                break;
+            case TOKEN_MONTH:
+                append_number(out, time_info->tm_mon + 1, token->width, token->pad);
+                break;
+            case TOKEN_YEAR:
+                append_number(out, time_info->tm_year + 1900, token->width, token->pad);
+                break;
+            case TOKEN_YEAR2:
+                append_number(out, (time_info->tm_year + 1900) % 100, token->width, token->pad);
+                break;
+            case TOKEN_YDAY:
+                append_number(out, time_info->tm_yday + 1, token->width, token->pad);
+                break;
+            case TOKEN_STRFTIME: {
+                gchar spec[32];
+                gchar buffer[128];
+                gchar *utf8;
+                gsize length;
+                
+                g_strlcpy(spec, compiled->strings->str + token->offset, MIN(token->length + 1, sizeof(spec)));
+                length = strftime(buffer, sizeof(buffer), spec, time_info);
+                utf8 = g_locale_to_utf8(buffer, length, NULL, &length, NULL);
+                if (utf8 != NULL)
+                    g_string_append_len(out, utf8, length);
+                g_free(utf8);
+                break;
+            }
+        }
     }
     
-    if (p != NULL) {
-        /* Convert to lowercase */
-        p[0] = tolower(p[0]);
-        p[1] = tolower(p[1]);
+    AXISCLOCK_PROBE_END(AXISCLOCK_PROBE_FORMAT, probe_start);
+    
+    return g_string_free(out, FALSE);
+}
+
+/* Seconds between changes of the formatted text: 1 if the format shows
+ * seconds, 60 otherwise */
+guint
+axisclock_format_get_granularity(const gchar *format)
+{
+    if (format == NULL)
+        return 60;
+    
+    return get_compiled_format(format)->granularity;
+}
+
+/* Copy of @format for minute-rate updates: %S is removed with the ':' or
+ * '.' before it, %T becomes %R and %r becomes "%I:%M %p". Locale
+ * representations that include seconds (%c, %X) are kept as they are. */
+gchar *
+axisclock_format_without_seconds(const gchar *format)
+{
+    GString *out = g_string_new(NULL);
+    const gchar *p = format;
+    
+    while (*p != '\0') {
+        const gchar *spec = p;
+        
+        if (*p != '%') {
+            g_string_append_c(out, *p++);
+            continue;
+        }
+        
+        /* Flags, width and E/O modifier as in compile_format() */
+        p++;
+        while (*p != '\0' && strchr("-_0^#", *p) != NULL)
+            p++;
+        while (g_ascii_isdigit(*p))
+            p++;
+        if (*p == 'E' || *p == 'O')
+            p++;
         
-        /* Remove space before AM/PM if present */
-        if (p > formatted_time && *(p - 1) == ' ') {
-            memmove(p - 1, p, strlen(p) + 1);
+        if (*p == '\0') {
+            g_string_append(out, spec);
+            break;
         }
+        
+        switch (*p) {
+            case 'S':
+                if (out->len > 0 && (out->str[out->len - 1] == ':' || out->str[out->len - 1] == '.'))
+                    g_string_truncate(out, out->len - 1);
+                break;
+            case 'T': g_string_append(out, "%R"); break;
+            case 'r': g_string_append(out, "%I:%M %p"); break;
+            default: g_string_append_len(out, spec, p + 1 - spec); break;
+        }
+        p++;
     }
     
-    return formatted_time;
+    return g_string_free(out, FALSE);
+}
+
+/* Five-minute slots in a day */
+#define FUZZY_SLOTS (24 * 60 / 5)
+
+static const gchar *fuzzy_hours[24] = {
+    "midnight", "one", "two", "three", "four", "five", "six", "seven", "eight", "nine", "ten", "eleven",
+    "noon", "one", "two", "three", "four", "five", "six", "seven", "eight", "nine", "ten", "eleven"
+};
+
+/* By five-minute step within the hour; from "twenty-five to" on the
+ * phrase names the next hour */
+static const gchar *fuzzy_patterns[12] = {
+    "%s o'clock", "five past %s", "ten past %s", "quarter past %s",
+    "twenty past %s", "twenty-five past %s", "half past %s", "twenty-five to %s",
+    "twenty to %s", "quarter to %s", "ten to %s", "five to %s"
+};
+
+/* Every phrase of the day, built once */
+static gchar *fuzzy_phrases[FUZZY_SLOTS];
+
+static void
+fuzzy_phrases_build(void)
+{
+    for (guint slot = 0; slot < FUZZY_SLOTS; slot++) {
+        guint hour = slot / 12;
+        guint step = slot % 12;
+        gchar *phrase;
+        
+        if (step == 0 && hour % 12 == 0)
+            phrase = g_strdup(fuzzy_hours[hour]);
+        else
+            phrase = g_strdup_printf(fuzzy_patterns[step], fuzzy_hours[step < 7 ? hour : (hour + 1) % 24]);
+        
+        phrase[0] = g_ascii_toupper(phrase[0]);
+        fuzzy_phrases[slot] = phrase;
+    }
+}
+
+/* Fuzzy phrase for @time_info, rounded down to a @slot_minutes boundary so
+ * the text changes exactly when a new slot starts. @slot_minutes must be a
+ * multiple of 5 that divides 60. The result is owned by the table. */
+const gchar *
+axisclock_format_fuzzy(const struct tm *time_info, guint slot_minutes)
+{
+    guint minute_of_day;
+    
+    if (G_UNLIKELY(fuzzy_phrases[0] == NULL))
+        fuzzy_phrases_build();
+    
+    slot_minutes = CLAMP(slot_minutes, 5, 60);
+    minute_of_day = time_info->tm_hour * 60 + time_info->tm_min;
+    minute_of_day -= minute_of_day % slot_minutes;
+    
+    return fuzzy_phrases[minute_of_day / 5];
 }
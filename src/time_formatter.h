@@ -25,6 +25,7 @@
 #define __TIME_FORMATTER_H__
 
 #include <glib.h>
+#include <time.h>
 #include "plugin_config.h"
 
 G_BEGIN_DECLS
@@ -34,6 +35,10 @@ G_BEGIN_DECLS
 
 /* Function prototypes */
 gchar *axisclock_get_formatted_time(PluginConfig *config);
+gchar *axisclock_format_time(const gchar *format, const struct tm *time_info);
+guint  axisclock_format_get_granularity(const gchar *format);
+gchar *axisclock_format_without_seconds(const gchar *format);
+const gchar *axisclock_format_fuzzy(const struct tm *time_info, guint slot_minutes);
 
 G_END_DECLS
 
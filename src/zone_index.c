@@ -0,0 +1,546 @@
+/*
+ * xfce4-axisclock-plugin - A macOS-style clock plugin for the Xfce panel
+ *
+ * Copyright (c) 2025 Kamil 'Novik' Nowicki <novik@axisos.org>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Website: https://axisos.org
+ * Repository: https://github.com/AxisOS/xfce4-axisclock-plugin
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <glib.h>
+#include <string.h>
+
+#include "data_cache.h"
+#include "zone_index.h"
+
+/* Identifiers under these are real places; other link names are legacy
+ * aliases such as "US/Eastern" and only become search keys */
+static const gchar *const zone_regions[] = {
+    "Africa/", "America/", "Antarctica/", "Arctic/", "Asia/",
+    "Atlantic/", "Australia/", "Europe/", "Indian/", "Pacific/"
+};
+
+/* Horizon of the search for a zone's next transition; zones without one
+ * in it are looked at again after it */
+#define ZONE_OFFSET_HORIZON (366 * 24 * 3600)
+
+/* tzdata files the index is built from */
+static const gchar *const zone_sources[] = {
+    "iso3166.tab", "zone1970.tab", "zone.tab", "tzdata.zi"
+};
+
+/* The serialized index, as stored in the shared data cache: this header,
+ * the zone and key records, then the string pool. Strings are offsets
+ * into the pool, which starts with "" */
+typedef struct {
+    guint32 n_zones;
+    guint32 n_keys;
+    guint32 strings_size;
+    guint32 reserved;
+} IndexHeader;
+
+typedef struct {
+    guint32 identifier;
+    guint32 city;
+    guint32 country;
+} ZoneRecord;
+
+typedef struct {
+    guint32 text;                   /* Normalized word suffix */
+    guint32 zone;
+} KeyRecord;
+
+/* A serialized index in use; keys and strings are read in place, usually
+ * from the shared mapping */
+typedef struct {
+    GBytes            *data;
+    const KeyRecord   *keys;        /* Sorted by text */
+    guint              n_keys;
+    const gchar       *strings;
+    AxisClockZoneInfo *zones;       /* Views into @strings, offsets of this process */
+    guint              n_zones;
+    gint64            *next_change; /* When each zone's offset goes stale, 0 if never computed */
+    guint             *seen;        /* Search generation that last returned each zone */
+    guint              generation;
+} ZoneIndex;
+
+/* Build-time state, dropped once the index is serialized */
+typedef struct {
+    GString    *strings;            /* Pool of NUL-terminated strings */
+    GHashTable *offsets;            /* pooled string -> offset + 1 */
+    GArray     *zones;              /* ZoneRecord */
+    GArray     *keys;               /* KeyRecord */
+    GHashTable *by_id;              /* identifier -> zone index + 1 */
+    GPtrArray  *countries;          /* "CC[,CC...]" per zone, display country first */
+} ZoneIndexBuilder;
+
+static ZoneIndex *zone_index = NULL;
+
+static const gchar *
+zone_index_dir(void)
+{
+    const gchar *dir = g_getenv("TZDIR");
+    
+    return dir != NULL && *dir != '\0' ? dir : "/usr/share/zoneinfo";
+}
+
+/* Lines of a tzdata file, NULL if it cannot be read */
+static gchar **
+zone_index_read_lines(const gchar *name)
+{
+    gchar *path = g_build_filename(zone_index_dir(), name, NULL);
+    gchar *contents = NULL;
+    gchar **lines = NULL;
+    
+    if (g_file_get_contents(path, &contents, NULL, NULL))
+        lines = g_strsplit(contents, "\n", -1);
+    
+    g_free(contents);
+    g_free(path);
+    return lines;
+}
+
+/* Lowercase ASCII with '/', '_' and '-' turned into word breaks, so that
+ * "Port-au-Prince", "port au" and "Côte" all compare */
+static gchar *
+zone_index_normalize(const gchar *text)
+{
+    gchar *ascii = g_str_to_ascii(text, "C");
+    gchar *lower = g_ascii_strdown(ascii, -1);
+    
+    g_free(ascii);
+    g_strdelimit(lower, "/_-", ' ');
+    return lower;
+}
+
+static gboolean
+zone_index_is_region(const gchar *identifier)
+{
+    for (guint i = 0; i < G_N_ELEMENTS(zone_regions); i++) {
+        if (g_str_has_prefix(identifier, zone_regions[i]))
+            return TRUE;
+    }
+    return FALSE;
+}
+
+/* Current UTC offset of @identifier and when it may next change, 0 if
+ * the zone cannot be opened */
+static gint32
+zone_index_offset(const gchar *identifier, gint64 now, gint64 *next_change)
+{
+    GTimeZone *tz;
+    gint interval;
+    gint32 offset;
+    
+    *next_change = now + ZONE_OFFSET_HORIZON;
+    
+#if GLIB_CHECK_VERSION(2, 68, 0)
+    tz = g_time_zone_new_identifier(identifier);
+#else
+    tz = g_time_zone_new(identifier);
+#endif
+    if (tz == NULL)
+        return 0;
+    
+    interval = g_time_zone_find_interval(tz, G_TIME_TYPE_UNIVERSAL, now);
+    offset = g_time_zone_get_offset(tz, interval);
+    
+    /* Intervals are numbered in time order, so bisect for the first
+     * second of a later one */
+    if (g_time_zone_find_interval(tz, G_TIME_TYPE_UNIVERSAL, *next_change) != interval) {
+        gint64 lo = now;
+        gint64 hi = *next_change;
+        
+        while (hi - lo > 1) {
+            gint64 mid = lo + (hi - lo) / 2;
+            
+            if (g_time_zone_find_interval(tz, G_TIME_TYPE_UNIVERSAL, mid) == interval)
+                lo = mid;
+            else
+                hi = mid;
+        }
+        *next_change = hi;
+    }
+    
+    g_time_zone_unref(tz);
+    return offset;
+}
+
+/* Offset of @text in the pool, adding it if it is new */
+static guint32
+zone_index_intern(ZoneIndexBuilder *builder, const gchar *text)
+{
+    gpointer value = g_hash_table_lookup(builder->offsets, text);
+    guint32 offset;
+    
+    if (value != NULL)
+        return GPOINTER_TO_UINT(value) - 1;
+    
+    offset = builder->strings->len;
+    g_string_append_len(builder->strings, text, strlen(text) + 1);
+    g_hash_table_insert(builder->offsets, g_strdup(text), GUINT_TO_POINTER(offset + 1));
+    
+    return offset;
+}
+
+/* Index of @identifier, adding it with @countries if it is new */
+static guint
+zone_index_add_zone(ZoneIndexBuilder *builder, const gchar *identifier, const gchar *countries)
+{
+    gpointer value = g_hash_table_lookup(builder->by_id, identifier);
+    ZoneRecord record = { 0 };
+    const gchar *base;
+    gchar *city;
+    
+    if (value != NULL)
+        return GPOINTER_TO_UINT(value) - 1;
+    
+    record.identifier = zone_index_intern(builder, identifier);
+    
+    /* "America/New_York" is shown as "New York" */
+    base = strrchr(identifier, '/');
+    city = g_strdup(base != NULL ? base + 1 : identifier);
+    g_strdelimit(city, "_", ' ');
+    record.city = zone_index_intern(builder, city);
+    g_free(city);
+    
+    g_array_append_val(builder->zones, record);
+    g_ptr_array_add(builder->countries, g_strdup(countries != NULL ? countries : ""));
+    g_hash_table_insert(builder->by_id, g_strdup(identifier), GUINT_TO_POINTER(builder->zones->len));
+    
+    return builder->zones->len - 1;
+}
+
+/* Add a key for every word start of @text */
+static void
+zone_index_add_words(ZoneIndexBuilder *builder, const gchar *text, guint zone)
+{
+    gchar *normalized = zone_index_normalize(text);
+    guint32 stored = zone_index_intern(builder, normalized);
+    
+    for (const gchar *p = normalized; *p != '\0'; p++) {
+        if (*p != ' ' && (p == normalized || p[-1] == ' ')) {
+            KeyRecord key = { stored + (guint32)(p - normalized), zone };
+            
+            g_array_append_val(builder->keys, key);
+        }
+    }
+    
+    g_free(normalized);
+}
+
+static gint
+key_record_compare(gconstpointer a, gconstpointer b, gpointer strings)
+{
+    return strcmp((const gchar *)strings + ((const KeyRecord *)a)->text,
+                  (const gchar *)strings + ((const KeyRecord *)b)->text);
+}
+
+/* Read the tzdata tables into a sorted, serialized index */
+static GBytes *
+zone_index_build(void)
+{
+    ZoneIndexBuilder builder;
+    GHashTable *country_names = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, g_free);
+    IndexHeader header = { 0 };
+    GByteArray *data;
+    gchar **lines;
+    guint utc;
+    
+    builder.strings = g_string_new(NULL);
+    builder.offsets = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
+    builder.zones = g_array_new(FALSE, FALSE, sizeof(ZoneRecord));
+    builder.keys = g_array_new(FALSE, FALSE, sizeof(KeyRecord));
+    builder.by_id = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
+    builder.countries = g_ptr_array_new_with_free_func(g_free);
+    
+    /* Offset 0 is "", the country of zones without one */
+    zone_index_intern(&builder, "");
+    
+    /* UTC is in none of the tables but always selectable */
+    utc = zone_index_add_zone(&builder, "Etc/UTC", NULL);
+    g_array_index(builder.zones, ZoneRecord, utc).city = zone_index_intern(&builder, "UTC");
+    
+    /* iso3166.tab: "CC<tab>Country name" */
+    lines = zone_index_read_lines("iso3166.tab");
+    for (gchar **line = lines; line != NULL && *line != NULL; line++) {
+        gchar **fields;
+        
+        if (**line == '#' || **line == '\0')
+            continue;
+        
+        fields = g_strsplit(*line, "\t", 2);
+        if (fields[0] != NULL && fields[1] != NULL)
+            g_hash_table_insert(country_names, g_strdup(fields[0]), g_strdup(fields[1]));
+        g_strfreev(fields);
+    }
+    g_strfreev(lines);
+    
+    /* zone1970.tab: "CC[,CC...]<tab>coordinates<tab>TZ[<tab>comments]";
+     * zone.tab has one country per zone and a few zones merged above */
+    for (guint pass = 0; pass < 2; pass++) {
+        lines = zone_index_read_lines(pass == 0 ? "zone1970.tab" : "zone.tab");
+        
+        for (gchar **line = lines; line != NULL && *line != NULL; line++) {
+            gchar **fields;
+            
+            if (**line == '#' || **line == '\0')
+                continue;
+            
+            fields = g_strsplit(*line, "\t", 4);
+            if (fields[0] != NULL && fields[1] != NULL && fields[2] != NULL) {
+                guint zone = zone_index_add_zone(&builder, fields[2], fields[0]);
+                gchar *countries = g_ptr_array_index(builder.countries, zone);
+                
+                /* zone.tab's single country is the one to display */
+                if (pass == 1 && !g_str_has_prefix(countries, fields[0])) {
+                    g_ptr_array_index(builder.countries, zone) = g_strconcat(fields[0], ",", countries, NULL);
+                    g_free(countries);
+                }
+            }
+            g_strfreev(fields);
+        }
+        g_strfreev(lines);
+    }
+    
+    /* tzdata.zi links: "L target alias" */
+    lines = zone_index_read_lines("tzdata.zi");
+    for (gchar **line = lines; line != NULL && *line != NULL; line++) {
+        gchar **fields;
+        gpointer target;
+        
+        if (!g_str_has_prefix(*line, "L "))
+            continue;
+        
+        fields = g_strsplit(*line + 2, " ", 3);
+        target = fields[0] != NULL && fields[1] != NULL ? g_hash_table_lookup(builder.by_id, fields[0]) : NULL;
+        if (target != NULL) {
+            guint zone = GPOINTER_TO_UINT(target) - 1;
+            
+            if (zone_index_is_region(fields[1]))
+                zone_index_add_zone(&builder, fields[1], g_ptr_array_index(builder.countries, zone));
+            else
+                zone_index_add_words(&builder, fields[1], zone);
+        }
+        g_strfreev(fields);
+    }
+    g_strfreev(lines);
+    
+    /* Keys for identifiers and country names */
+    for (guint i = 0; i < builder.zones->len; i++) {
+        gchar **codes = g_strsplit(g_ptr_array_index(builder.countries, i), ",", -1);
+        gchar *identifier;
+        
+        for (guint j = 0; codes[j] != NULL; j++) {
+            const gchar *name = g_hash_table_lookup(country_names, codes[j]);
+            
+            if (name == NULL)
+                continue;
+            if (g_array_index(builder.zones, ZoneRecord, i).country == 0)
+                g_array_index(builder.zones, ZoneRecord, i).country = zone_index_intern(&builder, name);
+            zone_index_add_words(&builder, name, i);
+        }
+        g_strfreev(codes);
+        
+        /* The pool may move while words are added */
+        identifier = g_strdup(builder.strings->str + g_array_index(builder.zones, ZoneRecord, i).identifier);
+        zone_index_add_words(&builder, identifier, i);
+        g_free(identifier);
+    }
+    
+    g_array_sort_with_data(builder.keys, key_record_compare, builder.strings->str);
+    
+    /* Serialize into one pointer-free block */
+    header.n_zones = builder.zones->len;
+    header.n_keys = builder.keys->len;
+    header.strings_size = builder.strings->len;
+    
+    data = g_byte_array_sized_new(sizeof(header) + builder.zones->len * sizeof(ZoneRecord) +
+                                  builder.keys->len * sizeof(KeyRecord) + builder.strings->len);
+    g_byte_array_append(data, (const guint8 *)&header, sizeof(header));
+    g_byte_array_append(data, (const guint8 *)builder.zones->data, builder.zones->len * sizeof(ZoneRecord));
+    g_byte_array_append(data, (const guint8 *)builder.keys->data, builder.keys->len * sizeof(KeyRecord));
+    g_byte_array_append(data, (const guint8 *)builder.strings->str, builder.strings->len);
+    
+    g_string_free(builder.strings, TRUE);
+    g_hash_table_destroy(builder.offsets);
+    g_array_free(builder.zones, TRUE);
+    g_array_free(builder.keys, TRUE);
+    g_hash_table_destroy(builder.by_id);
+    g_ptr_array_free(builder.countries, TRUE);
+    g_hash_table_destroy(country_names);
+    
+    return g_byte_array_free_to_bytes(data);
+}
+
+/* Use the serialized index in @data, NULL if it is malformed */
+static ZoneIndex *
+zone_index_open(GBytes *data)
+{
+    gsize size;
+    const guint8 *base = g_bytes_get_data(data, &size);
+    const IndexHeader *header = (const IndexHeader *)base;
+    const ZoneRecord *zones;
+    ZoneIndex *index;
+    
+    if (size < sizeof(*header) ||
+        size != sizeof(*header) + (gsize)header->n_zones * sizeof(ZoneRecord) +
+                (gsize)header->n_keys * sizeof(KeyRecord) + header->strings_size ||
+        header->strings_size == 0 || base[size - 1] != '\0')
+        return NULL;
+    
+    zones = (const ZoneRecord *)(header + 1);
+    index = g_new0(ZoneIndex, 1);
+    index->keys = (const KeyRecord *)(zones + header->n_zones);
+    index->n_keys = header->n_keys;
+    index->strings = (const gchar *)(index->keys + header->n_keys);
+    index->n_zones = header->n_zones;
+    
+    /* Every offset has to land inside the pool */
+    for (guint i = 0; i < index->n_keys; i++) {
+        if (index->keys[i].text >= header->strings_size || index->keys[i].zone >= index->n_zones) {
+            g_free(index);
+            return NULL;
+        }
+    }
+    
+    index->zones = g_new0(AxisClockZoneInfo, index->n_zones);
+    for (guint i = 0; i < index->n_zones; i++) {
+        if (zones[i].identifier >= header->strings_size || zones[i].city >= header->strings_size ||
+            zones[i].country >= header->strings_size) {
+            g_free(index->zones);
+            g_free(index);
+            return NULL;
+        }
+        index->zones[i].identifier = index->strings + zones[i].identifier;
+        index->zones[i].city = index->strings + zones[i].city;
+        index->zones[i].country = index->strings + zones[i].country;
+    }
+    
+    index->data = g_bytes_ref(data);
+    index->seen = g_new0(guint, index->n_zones);
+    /* Offsets depend on the time, so they are kept per process rather
+     * than in the shared data, and only looked up for returned zones */
+    index->next_change = g_new0(gint64, index->n_zones);
+    
+    return index;
+}
+
+/* The index from the shared data cache, built and shared on a miss */
+static ZoneIndex *
+zone_index_load(void)
+{
+    const gchar *paths[G_N_ELEMENTS(zone_sources) + 1] = { NULL };
+    ZoneIndex *index = NULL;
+    GBytes *data;
+    guint64 stamp;
+    
+    for (guint i = 0; i < G_N_ELEMENTS(zone_sources); i++)
+        paths[i] = g_build_filename(zone_index_dir(), zone_sources[i], NULL);
+    stamp = axisclock_data_cache_stamp(paths, NULL);
+    for (guint i = 0; i < G_N_ELEMENTS(zone_sources); i++)
+        g_free((gchar *)paths[i]);
+    
+    data = axisclock_data_cache_lookup("zone-index", stamp);
+    if (data != NULL) {
+        index = zone_index_open(data);
+        g_bytes_unref(data);
+    }
+    
+    if (index == NULL) {
+        data = zone_index_build();
+        axisclock_data_cache_store("zone-index", stamp, g_bytes_get_data(data, NULL), g_bytes_get_size(data));
+        index = zone_index_open(data);
+        g_bytes_unref(data);
+    }
+    
+    return index;
+}
+
+/**
+ * axisclock_zone_index_search:
+ * @query: Start of any word of a zone, city, alias or country name
+ * @results: Array receiving up to @max_results matches
+ * @max_results: Size of @results
+ *
+ * Finds zones having a word that starts with @query, ignoring case,
+ * accents and the separators in identifiers. Matches come in key order
+ * and each zone appears once. The index is built by the first call.
+ *
+ * Returns: The number of entries stored in @results.
+ */
+guint
+axisclock_zone_index_search(const gchar *query, const AxisClockZoneInfo **results, guint max_results)
+{
+    gint64 now = g_get_real_time() / G_USEC_PER_SEC;
+    gchar *needle;
+    gsize length;
+    guint lo, hi, n = 0;
+    
+    g_return_val_if_fail(query != NULL && results != NULL, 0);
+    
+    if (zone_index == NULL)
+        zone_index = zone_index_load();
+    if (zone_index == NULL)
+        return 0;
+    
+    needle = g_strstrip(zone_index_normalize(query));
+    length = strlen(needle);
+    if (length == 0) {
+        g_free(needle);
+        return 0;
+    }
+    
+    /* First key not below the needle */
+    lo = 0;
+    hi = zone_index->n_keys;
+    while (lo < hi) {
+        guint mid = lo + (hi - lo) / 2;
+        
+        if (strcmp(zone_index->strings + zone_index->keys[mid].text, needle) < 0)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    
+    if (++zone_index->generation == 0) {
+        memset(zone_index->seen, 0, zone_index->n_zones * sizeof(guint));
+        zone_index->generation = 1;
+    }
+    
+    for (guint i = lo; i < zone_index->n_keys && n < max_results; i++) {
+        const KeyRecord *key = &zone_index->keys[i];
+        AxisClockZoneInfo *info = &zone_index->zones[key->zone];
+        
+        if (strncmp(zone_index->strings + key->text, needle, length) != 0)
+            break;
+        if (zone_index->seen[key->zone] == zone_index->generation)
+            continue;
+        
+        zone_index->seen[key->zone] = zone_index->generation;
+        if (now >= zone_index->next_change[key->zone])
+            info->offset = zone_index_offset(info->identifier, now, &zone_index->next_change[key->zone]);
+        results[n++] = info;
+    }
+    
+    g_free(needle);
+    return n;
+}
@@ -0,0 +1,62 @@
+/*
+ * xfce4-axisclock-plugin - A macOS-style clock plugin for the Xfce panel
+ *
+ * Copyright (c) 2025 Kamil 'Novik' Nowicki <novik@axisos.org>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Website: https://axisos.org
+ * Repository: https://github.com/AxisOS/xfce4-axisclock-plugin
+ */
+
+#ifndef __ZONE_INDEX_H__
+#define __ZONE_INDEX_H__
+
+#include <glib.h>
+
+G_BEGIN_DECLS
+
+/**
+ * AxisClockZoneInfo:
+ * @identifier: Olson identifier, e.g. "Europe/Paris"
+ * @city: Human readable city name, e.g. "Paris"
+ * @country: Country name from iso3166.tab, or "" for none
+ * @offset: Seconds east of UTC now, looked up when the zone is returned
+ *
+ * One selectable zone. All strings are owned by the index.
+ */
+typedef struct _AxisClockZoneInfo {
+    const gchar *identifier;
+    const gchar *city;
+    const gchar *country;
+    gint32       offset;
+} AxisClockZoneInfo;
+
+/*
+ * Prefix search over the tz database. The index is built on the first
+ * search from zone1970.tab, zone.tab, iso3166.tab and the links in
+ * tzdata.zi, or mapped from the shared data cache when another instance
+ * built it from the same files, and kept for the life of the process.
+ * Every word of a zone's identifier, city, aliases and country names is a
+ * sorted key, so a query is one binary search plus a scan over the
+ * matching keys.
+ */
+guint axisclock_zone_index_search (const gchar              *query,
+                                   const AxisClockZoneInfo **results,
+                                   guint                     max_results);
+
+G_END_DECLS
+
+#endif /* !__ZONE_INDEX_H__ */
@@ -0,0 +1,304 @@
+/*
+ * xfce4-axisclock-plugin - A macOS-style clock plugin for the Xfce panel
+ *
+ * Copyright (c) 2025 Kamil 'Novik' Nowicki <novik@axisos.org>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Website: https://axisos.org
+ * Repository: https://github.com/AxisOS/xfce4-axisclock-plugin
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <glib.h>
+#include <string.h>
+#include <time.h>
+
+#include "data_cache.h"
+#include "zone_table.h"
+
+/* How far ahead one table build reaches (about 13 months) */
+#define ZONE_TABLE_HORIZON (400 * 86400)
+
+/* Probe step while scanning for transitions; no zone changes twice a day */
+#define ZONE_TABLE_STEP 86400
+
+/* Margin kept before the build time so small clock steps back stay in range */
+#define ZONE_TABLE_BACKLOG (7 * 86400)
+
+/* Shared cache entry of one zone: this header, then the spans */
+typedef struct {
+    gint64  valid_until;
+    guint32 n_spans;
+    guint32 reserved;
+} ZoneTableEntry;
+
+/* Open a zone by identifier, NULL if it is unknown */
+static GTimeZone *
+zone_open(const gchar *identifier)
+{
+#if GLIB_CHECK_VERSION(2, 68, 0)
+    return g_time_zone_new_identifier(identifier);
+#else
+    /* Older GLib silently falls back to UTC for unknown identifiers */
+    gchar *path = g_build_filename("/usr/share/zoneinfo", identifier, NULL);
+    gboolean exists = g_file_test(path, G_FILE_TEST_IS_REGULAR);
+    
+    g_free(path);
+    return exists ? g_time_zone_new(identifier) : NULL;
+#endif
+}
+
+/* Describe the interval containing @utc */
+static gint
+zone_fill_span(GTimeZone *tz, gint64 utc, AxisClockZoneSpan *span)
+{
+    gint interval = g_time_zone_find_interval(tz, G_TIME_TYPE_UNIVERSAL, utc);
+    
+    span->start = utc;
+    span->offset = g_time_zone_get_offset(tz, interval);
+    span->is_dst = g_time_zone_is_dst(tz, interval);
+    g_strlcpy(span->abbrev, g_time_zone_get_abbreviation(tz, interval), sizeof(span->abbrev));
+    
+    return interval;
+}
+
+/* Append @span unless it only repeats the previous one */
+static void
+zone_append_span(AxisClockZone *zone, const AxisClockZoneSpan *span)
+{
+    if (zone->spans->len > 0) {
+        const AxisClockZoneSpan *last = &g_array_index(zone->spans, AxisClockZoneSpan,
+                                                       zone->spans->len - 1);
+        if (last->offset == span->offset && last->is_dst == span->is_dst &&
+            strcmp(last->abbrev, span->abbrev) == 0)
+            return;
+    }
+    
+    g_array_append_vals(zone->spans, span, 1);
+}
+
+/* Rebuild the transition table starting at @from */
+static gboolean
+zone_build_table(AxisClockZone *zone, gint64 from)
+{
+    AxisClockZoneSpan span;
+    GTimeZone *tz;
+    gint64 t, end;
+    gint interval;
+    
+    g_array_set_size(zone->spans, 0);
+    zone->cursor = 0;
+    zone->valid_until = from;
+    
+    tz = zone_open(zone->identifier);
+    if (tz == NULL)
+        return FALSE;
+    
+    interval = zone_fill_span(tz, from, &span);
+    zone_append_span(zone, &span);
+    
+    end = from + ZONE_TABLE_HORIZON;
+    for (t = from; t < end; ) {
+        gint64 next = t + ZONE_TABLE_STEP;
+        gint64 lo, hi;
+        
+        if (g_time_zone_find_interval(tz, G_TIME_TYPE_UNIVERSAL, next) == interval) {
+            t = next;
+            continue;
+        }
+        
+        /* Bisect down to the first second of the new interval */
+        lo = t;
+        hi = next;
+        while (hi - lo > 1) {
+            gint64 mid = lo + (hi - lo) / 2;
+            
+            if (g_time_zone_find_interval(tz, G_TIME_TYPE_UNIVERSAL, mid) == interval)
+                lo = mid;
+            else
+                hi = mid;
+        }
+        
+        interval = zone_fill_span(tz, hi, &span);
+        zone_append_span(zone, &span);
+        t = hi;
+    }
+    
+    zone->valid_until = end;
+    g_time_zone_unref(tz);
+    
+    return TRUE;
+}
+
+/* Stamp of the zoneinfo file behind @identifier */
+static guint64
+zone_table_stamp(const gchar *identifier)
+{
+    const gchar *dir = g_getenv("TZDIR");
+    gchar *path = g_build_filename(dir != NULL && *dir != '\0' ? dir : "/usr/share/zoneinfo", identifier, NULL);
+    const gchar *paths[] = { path, NULL };
+    guint64 stamp = axisclock_data_cache_stamp(paths, NULL);
+    
+    g_free(path);
+    return stamp;
+}
+
+/* Fill the table starting at @from from the shared cache when a cached
+ * table covers @from and reaches far enough ahead; build and share it
+ * otherwise */
+static gboolean
+zone_load_table(AxisClockZone *zone, gint64 from)
+{
+    gchar *name = g_strconcat("zone/", zone->identifier, NULL);
+    guint64 stamp = zone_table_stamp(zone->identifier);
+    GBytes *bytes = axisclock_data_cache_lookup(name, stamp);
+    gboolean loaded = FALSE;
+    
+    if (bytes != NULL) {
+        gsize size;
+        const ZoneTableEntry *entry = g_bytes_get_data(bytes, &size);
+        const AxisClockZoneSpan *spans = (const AxisClockZoneSpan *)(entry + 1);
+        
+        if (size >= sizeof(*entry) && entry->n_spans > 0 &&
+            size == sizeof(*entry) + entry->n_spans * sizeof(*spans) &&
+            spans[0].start <= from + ZONE_TABLE_BACKLOG &&
+            entry->valid_until >= from + ZONE_TABLE_HORIZON / 2) {
+            g_array_set_size(zone->spans, 0);
+            g_array_append_vals(zone->spans, spans, entry->n_spans);
+            zone->cursor = 0;
+            zone->valid_until = entry->valid_until;
+            loaded = TRUE;
+        }
+        g_bytes_unref(bytes);
+    }
+    
+    if (!loaded && zone_build_table(zone, from)) {
+        gsize size = sizeof(ZoneTableEntry) + zone->spans->len * sizeof(AxisClockZoneSpan);
+        ZoneTableEntry *entry = g_malloc0(size);
+        
+        entry->valid_until = zone->valid_until;
+        entry->n_spans = zone->spans->len;
+        memcpy(entry + 1, zone->spans->data, zone->spans->len * sizeof(AxisClockZoneSpan));
+        axisclock_data_cache_store(name, stamp, entry, size);
+        g_free(entry);
+        loaded = TRUE;
+    }
+    
+    g_free(name);
+    return loaded;
+}
+
+/**
+ * axisclock_zone_new:
+ * @identifier: Olson time zone identifier
+ *
+ * Builds the offset table for @identifier around the current time, or takes
+ * it from the shared data cache when another instance already built it.
+ *
+ * Returns: A new #AxisClockZone, or %NULL if the zone is unknown.
+ */
+AxisClockZone *
+axisclock_zone_new(const gchar *identifier)
+{
+    AxisClockZone *zone;
+    const gchar *base;
+    
+    g_return_val_if_fail(identifier != NULL, NULL);
+    
+    zone = g_new0(AxisClockZone, 1);
+    zone->identifier = g_strdup(identifier);
+    zone->spans = g_array_new(FALSE, FALSE, sizeof(AxisClockZoneSpan));
+    
+    if (!zone_load_table(zone, g_get_real_time() / G_USEC_PER_SEC - ZONE_TABLE_BACKLOG)) {
+        axisclock_zone_free(zone);
+        return NULL;
+    }
+    
+    /* "America/New_York" is shown as "New York" */
+    base = strrchr(identifier, '/');
+    zone->display_name = g_strdup(base != NULL ? base + 1 : identifier);
+    g_strdelimit(zone->display_name, "_", ' ');
+    
+    return zone;
+}
+
+/**
+ * axisclock_zone_free:
+ * @zone: A #AxisClockZone
+ *
+ * Frees a zone and its transition table.
+ */
+void
+axisclock_zone_free(AxisClockZone *zone)
+{
+    if (zone == NULL)
+        return;
+    
+    g_free(zone->identifier);
+    g_free(zone->display_name);
+    g_array_free(zone->spans, TRUE);
+    g_free(zone);
+}
+
+/**
+ * axisclock_zone_localtime:
+ * @zone: A #AxisClockZone
+ * @utc: UTC seconds
+ * @time_info: Return location for the broken-down local time
+ *
+ * Converts @utc to @zone's local time. The table is walked from the span used
+ * last, so consecutive ticks cost a comparison; it is only rebuilt once @utc
+ * leaves the precomputed window. tm_zone points into the table and stays
+ * valid until the next call.
+ */
+void
+axisclock_zone_localtime(AxisClockZone *zone, gint64 utc, struct tm *time_info)
+{
+    const AxisClockZoneSpan *span;
+    time_t shifted;
+    
+    g_return_if_fail(zone != NULL && time_info != NULL);
+    
+    if (zone->spans->len == 0 ||
+        utc < g_array_index(zone->spans, AxisClockZoneSpan, 0).start ||
+        utc >= zone->valid_until)
+        zone_load_table(zone, utc - ZONE_TABLE_BACKLOG);
+    
+    if (zone->spans->len == 0) {
+        /* The zone disappeared from the system; show UTC */
+        shifted = (time_t)utc;
+        gmtime_r(&shifted, time_info);
+        return;
+    }
+    
+    while (zone->cursor + 1 < zone->spans->len &&
+           utc >= g_array_index(zone->spans, AxisClockZoneSpan, zone->cursor + 1).start)
+        zone->cursor++;
+    while (zone->cursor > 0 &&
+           utc < g_array_index(zone->spans, AxisClockZoneSpan, zone->cursor).start)
+        zone->cursor--;
+    
+    span = &g_array_index(zone->spans, AxisClockZoneSpan, zone->cursor);
+    
+    shifted = (time_t)(utc + span->offset);
+    gmtime_r(&shifted, time_info);
+    time_info->tm_isdst = span->is_dst ? 1 : 0;
+    time_info->tm_gmtoff = span->offset;
+    time_info->tm_zone = span->abbrev;
+}
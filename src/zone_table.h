@@ -0,0 +1,69 @@
+/*
+ * xfce4-axisclock-plugin - A macOS-style clock plugin for the Xfce panel
+ *
+ * Copyright (c) 2025 Kamil 'Novik' Nowicki <novik@axisos.org>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Website: https://axisos.org
+ * Repository: https://github.com/AxisOS/xfce4-axisclock-plugin
+ */
+
+#ifndef __ZONE_TABLE_H__
+#define __ZONE_TABLE_H__
+
+#include <glib.h>
+#include <time.h>
+
+G_BEGIN_DECLS
+
+/* One stretch of time during which a zone keeps the same UTC offset */
+typedef struct _AxisClockZoneSpan {
+    gint64   start;             /* UTC seconds the span begins at */
+    gint32   offset;            /* Seconds east of UTC */
+    gboolean is_dst;
+    gchar    abbrev[8];
+} AxisClockZoneSpan;
+
+/**
+ * AxisClockZone:
+ * @identifier: Olson identifier, e.g. "Europe/Warsaw"
+ * @display_name: Human readable city name derived from @identifier
+ * @spans: Sorted #AxisClockZoneSpan transition table
+ * @valid_until: First UTC second not covered by @spans
+ * @cursor: Index of the span used by the last lookup
+ *
+ * A precomputed offset/transition table for one time zone. Converting a
+ * UTC timestamp is a table lookup plus a gmtime_r(), so any number of zones
+ * can be rendered from a single clock read.
+ */
+typedef struct _AxisClockZone {
+    gchar  *identifier;
+    gchar  *display_name;
+    GArray *spans;
+    gint64  valid_until;
+    guint   cursor;
+} AxisClockZone;
+
+/* Function prototypes */
+AxisClockZone *axisclock_zone_new       (const gchar   *identifier);
+void           axisclock_zone_free      (AxisClockZone *zone);
+void           axisclock_zone_localtime (AxisClockZone *zone,
+                                         gint64         utc,
+                                         struct tm     *time_info);
+
+G_END_DECLS
+
+#endif /* !__ZONE_TABLE_H__ */